@@ -30,4 +30,51 @@ std::string calculateHash(std::span<const uint8_t> data) {
     std::vector<uint8_t> hash(picosha2::k_digest_size);
     picosha2::hash256(data.begin(), data.end(), hash);
     return picosha2::bytes_to_hex_string(hash.begin(), hash.end());
-}
\ No newline at end of file
+}
+
+uint64_t calculateFNV1a(std::string_view data) {
+    uint64_t hash = 0xcbf29ce484222325;
+    for (auto c : data) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+class SHA256Hasher::Impl {
+public:
+    picosha2::hash256_one_by_one hasher;
+};
+
+SHA256Hasher::SHA256Hasher() : m_impl(std::make_unique<Impl>()) {}
+SHA256Hasher::~SHA256Hasher() = default;
+
+void SHA256Hasher::update(std::span<const uint8_t> data) {
+    m_impl->hasher.process(data.begin(), data.end());
+}
+
+uint64_t SHA256Hasher::update(std::filesystem::path const& path, uint64_t size) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> buffer(64 * 1024);
+    uint64_t total = 0;
+    while (file && total < size) {
+        auto toRead = static_cast<std::streamsize>(std::min<uint64_t>(buffer.size(), size - total));
+        file.read(reinterpret_cast<char*>(buffer.data()), toRead);
+        auto read = file.gcount();
+        if (read <= 0) break;
+        m_impl->hasher.process(buffer.begin(), buffer.begin() + read);
+        total += static_cast<uint64_t>(read);
+    }
+    return total;
+}
+
+void SHA256Hasher::reset() {
+    m_impl->hasher.init();
+}
+
+std::string SHA256Hasher::digest() const {
+    // finishing pads the state, so do it on a copy to allow hashing more
+    auto hasher = m_impl->hasher;
+    hasher.finish();
+    return picosha2::get_hash_hex_string(hasher);
+}
@@ -3,6 +3,9 @@
 #include <string>
 #include <filesystem>
 #include <span>
+#include <string_view>
+#include <cstdint>
+#include <memory>
 
 std::string calculateSHA256(std::filesystem::path const& path);
 
@@ -13,3 +16,41 @@ std::string calculateSHA256Text(std::filesystem::path const& path);
  * used for verifying mods.
  */
 std::string calculateHash(std::span<const uint8_t> data);
+
+/**
+ * Calculates the 64-bit FNV-1a hash of the given data. Not
+ * cryptographic, used for telling whether save data changed
+ */
+uint64_t calculateFNV1a(std::string_view data);
+
+/**
+ * Calculates a SHA256 hash incrementally, for data that
+ * arrives in chunks (like downloads)
+ */
+class SHA256Hasher final {
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+
+public:
+    SHA256Hasher();
+    ~SHA256Hasher();
+
+    SHA256Hasher(SHA256Hasher const&) = delete;
+    SHA256Hasher& operator=(SHA256Hasher const&) = delete;
+
+    void update(std::span<const uint8_t> data);
+    /**
+     * Hashes the first `size` bytes of a file, or the whole
+     * file if it is shorter. Returns the number of bytes hashed
+     */
+    uint64_t update(std::filesystem::path const& path, uint64_t size);
+    /**
+     * Start over as if nothing had been hashed yet
+     */
+    void reset();
+    /**
+     * Get the hex digest of everything hashed so far. Doesn't
+     * reset the hasher
+     */
+    std::string digest() const;
+};
@@ -949,6 +949,8 @@ public:
      * ->getChildByIDRecursive("button-menu")
      * ->getChildByID("mod.id/epic-button")`
      * @returns The first matching node, or nullptr if none was found
+     * @note Recently used queries are cached; see geode::cocos::NodeQuery
+     * for keeping a parsed query around explicitly
      */
     GEODE_DLL CCNode* querySelector(std::string_view query);
 
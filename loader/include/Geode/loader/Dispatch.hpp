@@ -4,6 +4,7 @@
 #include "../utils/function.hpp"
 #include "../modify/Traits.hpp"
 
+#include <atomic>
 #include <functional>
 #include <string>
 #include <tuple>
@@ -11,31 +12,75 @@
 namespace geode {
     // Mod interoperability
 
+    /**
+     * The map of dispatch IDs to their listener pools. This is not
+     * synchronized in any way, so use `getDispatchPool` instead, which looks
+     * pools up under a lock. It is only still exported because mods built
+     * against older headers index it directly, and they have to keep sharing
+     * pools with everyone else
+     */
+    [[deprecated("This will be removed in v5, use getDispatchPool instead")]]
     GEODE_DLL std::unordered_map<std::string, EventListenerPool*>& dispatchPools();
 
+    /**
+     * An interned dispatch ID. The listener pool for the ID is looked up
+     * once and cached, so posting a DispatchEvent or registering a
+     * DispatchFilter with it skips the pool map entirely. Use the
+     * `$dispatch_id` macro to get one that is shared by every call at the
+     * same call site
+     */
+    class DispatchID final {
+    private:
+        std::string m_id;
+        mutable std::atomic<EventListenerPool*> m_pool = nullptr;
+
+    public:
+        explicit DispatchID(std::string id) : m_id(std::move(id)) {}
+
+        DispatchID(DispatchID const&) = delete;
+        DispatchID& operator=(DispatchID const&) = delete;
+
+        std::string const& getID() const {
+            return m_id;
+        }
+
+        EventListenerPool* getPool() const {
+            auto pool = m_pool.load(std::memory_order_acquire);
+            if (!pool) {
+                pool = getDispatchPool(m_id);
+                m_pool.store(pool, std::memory_order_release);
+            }
+            return pool;
+        }
+    };
+
     template <class... Args>
     class DispatchEvent : public Event {
     protected:
         std::string m_id;
         std::tuple<Args...> m_args;
+        mutable EventListenerPool* m_pool = nullptr;
 
     public:
         DispatchEvent(std::string const& id, Args... args) :
             m_id(id), m_args(std::make_tuple(args...)) {}
 
+        DispatchEvent(DispatchID const& id, Args... args) :
+            m_id(id.getID()), m_args(std::make_tuple(args...)), m_pool(id.getPool()) {}
+
         std::tuple<Args...> getArgs() const {
             return m_args;
         }
 
-        std::string getID() const {
+        std::string const& getID() const {
             return m_id;
         }
 
         EventListenerPool* getPool() const override {
-            if (dispatchPools().count(m_id) == 0) {
-                dispatchPools()[m_id] = DefaultEventListenerPool::create();
+            if (!m_pool) {
+                m_pool = getDispatchPool(m_id);
             }
-            return dispatchPools()[m_id];
+            return m_pool;
         }
     };
 
@@ -43,19 +88,21 @@ namespace geode {
     class DispatchFilter : public EventFilter<DispatchEvent<Args...>> {
     protected:
         std::string m_id;
+        mutable EventListenerPool* m_pool = nullptr;
 
     public:
         using Ev = DispatchEvent<Args...>;
         using Callback = ListenerResult(Args...);
 
         EventListenerPool* getPool() const {
-            if (dispatchPools().count(m_id) == 0) {
-                dispatchPools()[m_id] = DefaultEventListenerPool::create();
+            if (!m_pool) {
+                m_pool = getDispatchPool(m_id);
             }
-            return dispatchPools()[m_id];
+            return m_pool;
         }
 
         ListenerResult handle(std::function<Callback> fn, Ev* event) {
+            // pools are per-ID, so this is only a sanity check
             if (event->getID() == m_id) {
                 return std::apply(fn, event->getArgs());
             }
@@ -64,6 +111,8 @@ namespace geode {
 
         DispatchFilter(std::string const& id) : m_id(id) {}
 
+        DispatchFilter(DispatchID const& id) : m_id(id.getID()), m_pool(id.getPool()) {}
+
         DispatchFilter(DispatchFilter const&) = default;
     };
 }
@@ -103,6 +152,16 @@ Result<int> api::addNumbers(int a, int b) {
 ```
 */
 
+// Get an interned DispatchID for a string literal. The ID and its pool
+// are only resolved the first time the call site is reached:
+/*
+```
+geode::DispatchEvent<int>($dispatch_id("dev.my-api/number"), 5).post();
+```
+*/
+#define $dispatch_id(id) \
+    ([]() -> ::geode::DispatchID const& { static ::geode::DispatchID ret(id); return ret; }())
+
 // once this is set in stone we should not change it ever
 #define GEODE_EVENT_EXPORT_ID_FOR(fnPtrStr, callArgsStr) \
     (std::string(MY_MOD_ID "/") + (fnPtrStr[0] == '&' ? &fnPtrStr[1] : fnPtrStr))
@@ -4,10 +4,13 @@
 
 #include <Geode/DefaultInclude.hpp>
 #include <functional>
+#include <string>
 #include <memory>
 #include <type_traits>
+#include <typeinfo>
 #include <mutex>
 #include <deque>
+#include <unordered_map>
 #include <atomic>
 #include <vector>
 
@@ -40,14 +43,40 @@ namespace geode {
     template <class... Args>
     class DispatchFilter;
 
+    GEODE_DLL EventListenerPool* getDispatchPool(std::string const& id);
+
     class GEODE_DLL DefaultEventListenerPool : public EventListenerPool {
     protected:
         // fix this in Geode 4.0.0
         struct Data {
-            std::atomic_size_t m_locked = 0;
+            struct Entry;
+            struct Snapshot;
+
+            // Listeners are read through a copy-on-write snapshot, so
+            // handle() never has to take the mutex; it is only used to
+            // serialize writers
+            std::atomic<Snapshot*> m_snapshot = nullptr;
+            // handle() calls register as readers of the current epoch. The
+            // epoch can only advance once the readers of the previous one
+            // have left, so anything retired in an epoch is safe to free
+            // after the epoch has advanced twice
+            std::atomic_size_t m_epoch = 0;
+            std::atomic_size_t m_readers[2] = {};
+            std::atomic_bool m_hasRetired = false;
             std::mutex m_mutex;
-            std::deque<EventListenerProtocol*> m_listeners;
-            std::vector<EventListenerProtocol*> m_toAdd;
+            std::unordered_map<EventListenerProtocol*, Entry*> m_entries;
+            size_t m_dead = 0;
+            // Snapshots and entries that can't be freed yet, along with
+            // the epoch they were retired in
+            std::vector<std::pair<size_t, Snapshot*>> m_retiredSnapshots;
+            std::vector<std::pair<size_t, Entry*>> m_retiredEntries;
+
+            size_t enter();
+            void leave(size_t epoch);
+            void rebuild(Entry* append);
+            void reclaim();
+
+            ~Data();
         };
         std::unique_ptr<Data> m_data;
 
@@ -56,17 +85,40 @@ namespace geode {
         DefaultEventListenerPool();
 
     public:
+        ~DefaultEventListenerPool() override;
+
         bool add(EventListenerProtocol* listener) override;
         void remove(EventListenerProtocol* listener) override;
         ListenerResult handle(Event* event) override;
 
         static DefaultEventListenerPool* get();
 
+        /**
+         * Get the pool that holds listeners for events of a specific type.
+         * Listeners in these pools are only visited when an event that can
+         * be cast to the pool's type is posted, instead of every listener
+         * in the global pool having to check the event.
+         * @param name The name of the event type, i.e. `typeid(T).name()`
+         * @param accepts Function that checks whether an event can be
+         * cast to the event type
+         */
+        static DefaultEventListenerPool* getForType(char const* name, bool(*accepts)(Event*));
+
+        template <class T>
+        static DefaultEventListenerPool* getForType() {
+            static auto pool = getForType(typeid(T).name(), +[](Event* event) {
+                return cast::typeinfo_cast<T*>(event) != nullptr;
+            });
+            return pool;
+        }
+
         template <class... Args>
         friend class DispatchEvent;
 
         template <class... Args>
         friend class DispatchFilter;
+
+        friend EventListenerPool* getDispatchPool(std::string const& id);
     };
 
     class GEODE_DLL EventListenerProtocol {
@@ -108,7 +160,7 @@ namespace geode {
         }
 
         EventListenerPool* getPool() const {
-            return DefaultEventListenerPool::get();
+            return DefaultEventListenerPool::getForType<T>();
         }
 
         void setListener(EventListenerProtocol* listener) {
@@ -258,6 +310,21 @@ namespace geode {
     public:
         Mod* sender;
 
+        /**
+         * Send this event to its listeners. Events that use the default pool
+         * are delivered in this order:
+         *  1. listeners for the event's exact type,
+         *  2. listeners for each of the event's base types (the order between
+         *     different base types is unspecified),
+         *  3. listeners in the global pool, i.e. filters that don't override
+         *     `getPool`.
+         * Within one pool, the most recently added listener is called first.
+         * There is no ordering across pools: a listener for the exact type
+         * always runs before one for a base type, even if it was added later.
+         * As soon as any listener returns `ListenerResult::Stop`, no further
+         * listeners in any pool are called.
+         * @param sender The mod that is posting the event
+         */
         ListenerResult postFromMod(Mod* sender);
         template<class = void>
         ListenerResult post() {
@@ -18,6 +18,7 @@
 #include <matjson/stl_serialize.hpp>
 #include <optional>
 #include <string_view>
+#include <utility>
 #include <tulip/TulipHook.hpp>
 #include <type_traits>
 #include <unordered_map>
@@ -57,6 +58,9 @@ namespace geode {
 
     class ModImpl;
 
+    template <class T>
+    class SettingHandle;
+
     /**
      * Represents a Mod ingame.
      * @class Mod
@@ -234,6 +238,7 @@ namespace geode {
         }
 
         matjson::Value& getSaveContainer();
+        matjson::Value const& getSaveContainer() const;
         matjson::Value& getSavedSettingsData();
 
         /**
@@ -251,6 +256,15 @@ namespace geode {
             return T();
         }
 
+        /**
+         * Get a handle to the value of a setting. Unlike `getSettingValue`,
+         * the setting is only looked up once, so reading the value through
+         * the handle is cheap enough to do every frame
+         * @param key The key of the setting as defined in `mod.json`
+         */
+        template <class T>
+        SettingHandle<T> getSettingHandle(std::string_view key) const;
+
         template <class T>
         T setSettingValue(std::string_view key, T const& value) {
             using S = typename SettingTypeForValueType<T>::SettingType;
@@ -266,7 +280,7 @@ namespace geode {
 
         template <class T>
         T getSavedValue(std::string_view key) {
-            auto& saved = this->getSaveContainer();
+            auto& saved = std::as_const(*this).getSaveContainer();
             if (auto res = saved.get(key).andThen([](auto&& v) {
                 return v.template as<T>();
             }); res.isOk()) {
@@ -277,13 +291,13 @@ namespace geode {
 
         template <class T>
         T getSavedValue(std::string_view key, T const& defaultValue) {
-            auto& saved = this->getSaveContainer();
+            auto& saved = std::as_const(*this).getSaveContainer();
             if (auto res = saved.get(key).andThen([](auto&& v) {
                 return v.template as<T>();
             }); res.isOk()) {
                 return res.unwrap();
             }
-            saved[key] = matjson::Value(defaultValue);
+            this->getSaveContainer()[key] = matjson::Value(defaultValue);
             return defaultValue;
         }
 
@@ -328,6 +342,8 @@ namespace geode {
          * @returns Successful result containing the
          * Hook pointer, errorful result with info on
          * error
+         * @note See claimHook for hooks created from static
+         * initializers, whose enabling errors aren't returned here
          */
         template<class DetourType>
         Result<Hook*> hook(
@@ -355,6 +371,13 @@ namespace geode {
          * If the hook has "auto enable" set, this will enable the hook.
          * @returns Returns a pointer to the hook, or an error if the
          * hook already has an owner, or was unable to enable the hook.
+         * @note Hooks claimed while the mod's binary is being loaded (i.e.
+         * from static initializers, which is where $modify hooks come from)
+         * or before the loader is ready to hook are enabled together once
+         * loading has finished. For those, this returns Ok even if enabling
+         * fails later, and Hook::isEnabled() is false until then. Failures
+         * are logged to the mod; to check for them, look at
+         * Hook::isEnabled() from $on_mod(Loaded) or later
          */
         Result<Hook*> claimHook(std::shared_ptr<Hook> hook);
 
@@ -506,6 +529,82 @@ namespace geode {
 
         friend class ModImpl;
     };
+
+    /**
+     * A cached reference to the value of a setting, obtained through
+     * `Mod::getSettingHandle`. The handle keeps the setting alive and reads
+     * its value directly, so it always reflects the current value without
+     * looking the setting up again
+     * @note Like the rest of the settings API, this should only be read from
+     * the main thread
+     */
+    template <class T>
+    class SettingHandle final {
+    private:
+        using S = typename SettingTypeForValueType<T>::SettingType;
+        using V = std::remove_cvref_t<decltype(std::declval<S const&>().getValue())>;
+        static constexpr bool HAS_VALUE_REF = requires (S const& setting) {
+            { setting.getValueRef() } -> std::same_as<V const&>;
+        };
+        using Read = std::conditional_t<std::is_same_v<T, V>, V const&, T>;
+
+        Mod const* m_mod = nullptr;
+        std::string m_key;
+        // custom settings may not be registered yet when the handle is
+        // created, in which case resolving is retried on read
+        mutable std::shared_ptr<S> m_setting;
+        mutable V const* m_value = nullptr;
+
+        bool resolve() const {
+            if (!m_mod) return false;
+            m_setting = cast::typeinfo_pointer_cast<S>(m_mod->getSetting(m_key));
+            if constexpr (HAS_VALUE_REF) {
+                m_value = m_setting ? &m_setting->getValueRef() : nullptr;
+            }
+            return m_setting != nullptr;
+        }
+
+    public:
+        SettingHandle() = default;
+        SettingHandle(Mod const* mod, std::string_view key) : m_mod(mod), m_key(key) {
+            this->resolve();
+        }
+
+        /**
+         * Get the current value of the setting, or a default-constructed
+         * value if the setting doesn't exist
+         */
+        Read get() const {
+            if constexpr (HAS_VALUE_REF) {
+                if (m_value || this->resolve()) [[likely]] {
+                    return static_cast<Read>(*m_value);
+                }
+            }
+            else {
+                if (m_setting || this->resolve()) [[likely]] {
+                    return static_cast<T>(m_setting->getValue());
+                }
+            }
+            static V const fallback {};
+            return static_cast<Read>(fallback);
+        }
+        Read operator*() const {
+            return this->get();
+        }
+
+        /**
+         * Get the setting this handle refers to, or null if it doesn't exist
+         */
+        std::shared_ptr<S> getSetting() const {
+            if (!m_setting) this->resolve();
+            return m_setting;
+        }
+    };
+
+    template <class T>
+    SettingHandle<T> Mod::getSettingHandle(std::string_view key) const {
+        return SettingHandle<T>(this, key);
+    }
 }
 
 #ifdef GEODE_MOD_ID
@@ -280,6 +280,14 @@ namespace geode {
         T getValue() const {
             return m_impl->value;
         }
+        /**
+         * Get a reference to where the current value of this setting is
+         * stored. The reference stays valid, and keeps reflecting the
+         * current value, for as long as the setting exists
+         */
+        T const& getValueRef() const {
+            return m_impl->value;
+        }
         /**
          * Set the value of this setting. This will broadcast a new
          * SettingChangedEventV3, letting any listeners now the value has changed
@@ -4,6 +4,7 @@
 
 #include <Geode/loader/Loader.hpp>
 #include <cocos2d.h>
+#include <cstddef>
 #include <vector>
 
 namespace cocos2d {
@@ -16,6 +17,7 @@ namespace geode {
 }
 
 namespace geode::modifier {
+    // kept for mods built against headers from before registerField
     class FieldContainer {
     private:
         std::vector<void*> m_containedFields;
@@ -52,6 +54,86 @@ namespace geode::modifier {
 
     GEODE_DLL size_t getFieldIndexForClass(char const* name);
 
+    using FieldConstructor = void (*)(void*);
+    using FieldDestructor = void (*)(void*);
+
+    /**
+     * Where a single mod's fields for a class live, relative to the start
+     * of that class's field layout. Shared between every node of the class
+     */
+    struct FieldHandle {
+        size_t classSlot;
+        size_t index;
+        size_t offset;
+    };
+
+    /**
+     * Registers a mod's fields for a class, appending them to the layout
+     * shared by all mods modifying that class. Called once per Modify
+     */
+    GEODE_DLL FieldHandle registerField(
+        char const* forClass, size_t size, size_t alignment, FieldDestructor destructor
+    );
+
+    /**
+     * Get a mod's fields for a class on a node. The fields of every mod for
+     * that class live in a single arena per node, which is allocated the
+     * first time any of them is accessed. The fields are constructed with
+     * `constructor` the first time they are accessed
+     */
+    GEODE_DLL void* getField(cocos2d::CCNode* node, FieldHandle const& handle, FieldConstructor constructor);
+
+    /**
+     * The fields of every mod for one class on one node. Allocated and
+     * owned by the loader; `m_fields` reads these inline, so the layout is
+     * part of the mod ABI and can only ever be appended to
+     */
+    struct FieldArenaHeader {
+        size_t firstField;
+        size_t fieldCount;
+        // Offset of `data` within the class's field layout
+        size_t begin;
+        std::byte* data;
+        bool* constructed;
+    };
+
+    // The tag of the loader's metadata object in a node's user object
+    constexpr int NODE_METADATA_TAG = 0xB324ABC;
+
+    /**
+     * What the loader's metadata object starts with. Part of the mod ABI
+     */
+    struct NodeMetadataHeader : public cocos2d::CCObject {
+        // Indexed by class slot; null for nodes that never had fields
+        std::vector<FieldArenaHeader*>* fieldArenas = nullptr;
+    };
+
+    /**
+     * Get a mod's fields for a class on a node without calling into the
+     * loader, which works once the fields have been constructed
+     * @returns The fields, or null if `getField` has to be used
+     */
+    inline void* findConstructedField(cocos2d::CCNode* node, FieldHandle const& handle) {
+        auto meta = node->m_pUserObject;
+        if (!meta || meta->m_nTag != NODE_METADATA_TAG) {
+            return nullptr;
+        }
+        auto arenas = static_cast<NodeMetadataHeader*>(meta)->fieldArenas;
+        if (!arenas || arenas->size() <= handle.classSlot) {
+            return nullptr;
+        }
+        auto arena = (*arenas)[handle.classSlot];
+        if (!arena) {
+            return nullptr;
+        }
+        // fields in an overflow arena aren't in range here and take the slow path
+        auto field = handle.index - arena->firstField;
+        if (field >= arena->fieldCount || !arena->constructed[field]) {
+            return nullptr;
+        }
+        return arena->data + (handle.offset - arena->begin);
+    }
+
     template <class Parent, class Base>
     class FieldIntermediate {
         using Intermediate = Modify<Parent, Base>;
@@ -82,25 +164,22 @@ namespace geode::modifier {
             auto node = reinterpret_cast<Parent*>(reinterpret_cast<std::byte*>(this) - sizeof(Base));
             // static_assert(sizeof(Base) + sizeof() == sizeof(Intermediate), "offsetof not correct");
 
-            // generating the container if it doesn't exist
-            auto container = FieldContainer::from(node, typeid(Base).name());
-
-            // the index is global across all mods, so the
-            // function is defined in the loader source
-            static size_t index = getFieldIndexForClass(typeid(Base).name());
-
-            // the fields are actually offset from their original
-            // offset, this is done to save on allocation and space
-            auto offsetField = container->getField(index);
-            if (!offsetField) {
-                offsetField = container->setField(
-                    index, sizeof(typename Parent::Fields), &FieldIntermediate::fieldDestructor
-                );
+            // the layout is global across all mods, so the
+            // slot and offset are handed out by the loader
+            static FieldHandle const handle = registerField(
+                typeid(Base).name(),
+                sizeof(typename Parent::Fields),
+                alignof(typename Parent::Fields),
+                &FieldIntermediate::fieldDestructor
+            );
 
-                FieldIntermediate::fieldConstructor(offsetField);
+            // every access after the first takes the inline path
+            if (auto fields = findConstructedField(node, handle)) {
+                return reinterpret_cast<typename Parent::Fields*>(fields);
             }
-
-            return reinterpret_cast<typename Parent::Fields*>(offsetField);
+            return reinterpret_cast<typename Parent::Fields*>(
+                getField(node, handle, &FieldIntermediate::fieldConstructor)
+            );
         }
 
         auto operator->() {
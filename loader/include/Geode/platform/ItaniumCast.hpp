@@ -81,6 +81,17 @@ namespace geode::cast {
         return nullptr;
     }
 
+    inline void* typeinfoCastUncached(void* ptr, ClassTypeinfoType const* afterTypeinfo) {
+        auto vftable = *reinterpret_cast<VtableType**>(ptr);
+        auto dataPointer = static_cast<VtableTypeinfoType*>(static_cast<CompleteVtableType*>(vftable));
+        auto typeinfo = dataPointer->m_typeinfo;
+        auto basePtr = static_cast<std::byte*>(ptr) + dataPointer->m_offset;
+
+        auto afterIdent = afterTypeinfo->m_typeinfoName;
+
+        return traverseTypeinfoFor(basePtr, typeinfo, afterIdent);
+    }
+
     inline void* typeinfoCastInternal(void* ptr, ClassTypeinfoType const* beforeTypeinfo, ClassTypeinfoType const* afterTypeinfo, size_t hint) {
         // we're not using either because uhhh idk
         // hint is for diamond inheritance iirc which is never
@@ -93,13 +104,24 @@ namespace geode::cast {
         (void)hint;
 
         auto vftable = *reinterpret_cast<VtableType**>(ptr);
-        auto dataPointer = static_cast<VtableTypeinfoType*>(static_cast<CompleteVtableType*>(vftable));
-        auto typeinfo = dataPointer->m_typeinfo;
-        auto basePtr = static_cast<std::byte*>(ptr) + dataPointer->m_offset;
 
-        auto afterIdent = afterTypeinfo->m_typeinfoName;
+        // the vtable of a (sub)object fixes both the most derived type and
+        // where in it this subobject is, so the result can be reused
+        auto& cache = ::geode::geode_internal::TypeinfoCastCache::get();
+        std::ptrdiff_t offset;
+        if (cache.find(vftable, afterTypeinfo, offset)) {
+            if (offset == ::geode::geode_internal::TypeinfoCastCache::FAILED) {
+                return nullptr;
+            }
+            return static_cast<std::byte*>(ptr) + offset;
+        }
 
-        return traverseTypeinfoFor(basePtr, typeinfo, afterIdent);
+        auto ret = typeinfoCastUncached(ptr, afterTypeinfo);
+        cache.insert(
+            vftable, afterTypeinfo,
+            ret ? static_cast<std::byte*>(ret) - static_cast<std::byte*>(ptr) : ::geode::geode_internal::TypeinfoCastCache::FAILED
+        );
+        return ret;
     }
 
     template <class After, class Before>
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 
 namespace geode {
@@ -24,4 +27,83 @@ namespace geode::geode_internal {
         static_assert(!geode_internal::IsModifyClass<After>,
             "typeinfo_cast will not work with a Modify class. use static_cast<MyModifyClass*>(typeinfo_cast<Class*>(...)) instead");
     }
-}
\ No newline at end of file
+
+    /**
+     * Remembers where previous typeinfo_casts ended up, keyed by the vtable
+     * of the object being cast and the typeinfo of the type it's cast to.
+     * Both of those together always resolve to the same offset (or to the
+     * cast failing), so repeated casts skip walking the RTTI entirely.
+     *
+     * Lookups and inserts never lock: each slot is a pointer to an
+     * immutable entry that is published with a single compare-exchange.
+     * Once the table fills up, new results are simply not remembered
+     */
+    class TypeinfoCastCache final {
+    public:
+        // Stored for casts that fail
+        static constexpr std::ptrdiff_t FAILED = PTRDIFF_MIN;
+
+    private:
+        static constexpr size_t SLOT_COUNT = 4096;
+        static constexpr size_t MAX_PROBES = 8;
+
+        struct Entry {
+            void const* vtable;
+            void const* typeinfo;
+            std::ptrdiff_t offset;
+        };
+        std::atomic<Entry const*> m_slots[SLOT_COUNT] = {};
+
+        static size_t hash(void const* vtable, void const* typeinfo) {
+            auto a = reinterpret_cast<uintptr_t>(vtable) >> 3;
+            auto b = reinterpret_cast<uintptr_t>(typeinfo) >> 3;
+            return static_cast<size_t>((a ^ (b * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull >> 20);
+        }
+
+    public:
+        static TypeinfoCastCache& get() {
+            static TypeinfoCastCache cache;
+            return cache;
+        }
+
+        /**
+         * Returns true and sets `offset` if the cast has been done before
+         */
+        bool find(void const* vtable, void const* typeinfo, std::ptrdiff_t& offset) const {
+            auto index = hash(vtable, typeinfo);
+            for (size_t i = 0; i < MAX_PROBES; i++) {
+                auto entry = m_slots[(index + i) % SLOT_COUNT].load(std::memory_order_acquire);
+                if (!entry) {
+                    return false;
+                }
+                if (entry->vtable == vtable && entry->typeinfo == typeinfo) {
+                    offset = entry->offset;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void insert(void const* vtable, void const* typeinfo, std::ptrdiff_t offset) {
+            auto index = hash(vtable, typeinfo);
+            Entry const* entry = nullptr;
+            for (size_t i = 0; i < MAX_PROBES; i++) {
+                auto& slot = m_slots[(index + i) % SLOT_COUNT];
+                auto current = slot.load(std::memory_order_acquire);
+                if (current) {
+                    // someone else got here first
+                    if (current->vtable == vtable && current->typeinfo == typeinfo) break;
+                    continue;
+                }
+                if (!entry) {
+                    entry = new Entry { vtable, typeinfo, offset };
+                }
+                if (slot.compare_exchange_strong(current, entry, std::memory_order_acq_rel)) {
+                    return;
+                }
+                if (current->vtable == vtable && current->typeinfo == typeinfo) break;
+            }
+            delete entry;
+        }
+    };
+}
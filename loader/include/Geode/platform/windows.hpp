@@ -131,11 +131,22 @@ namespace geode::cast {
         auto basePtr = dynamic_cast<void*>(ptr);
         auto vftable = *reinterpret_cast<VftableType**>(basePtr);
 
-        auto metaPtr = static_cast<MetaPointerType*>(static_cast<CompleteVftableType*>(vftable));
-
         auto afterDesc =
             reinterpret_cast<TypeDescriptorType const*>(&typeid(std::remove_pointer_t<After>));
 
+        // the vftable of the complete object fixes its type, so the
+        // offset of a base class in it never changes
+        auto& cache = ::geode::geode_internal::TypeinfoCastCache::get();
+        std::ptrdiff_t cachedOffset;
+        if (cache.find(vftable, afterDesc, cachedOffset)) {
+            if (cachedOffset == ::geode::geode_internal::TypeinfoCastCache::FAILED) {
+                return nullptr;
+            }
+            return reinterpret_cast<After>(reinterpret_cast<std::byte*>(basePtr) + cachedOffset);
+        }
+
+        auto metaPtr = static_cast<MetaPointerType*>(static_cast<CompleteVftableType*>(vftable));
+
         auto afterIdent = static_cast<char const*>(afterDesc->m_typeDescriptorName);
 
     #ifdef GEODE_IS_X64
@@ -154,11 +165,13 @@ namespace geode::cast {
             auto optionOffset = entry->m_memberDisplacement[0];
 
             if (std::strcmp(afterIdent, optionIdent) == 0) {
+                cache.insert(vftable, afterDesc, optionOffset);
                 auto afterPtr = reinterpret_cast<std::byte*>(basePtr) + optionOffset;
                 return reinterpret_cast<After>(afterPtr);
             }
         }
 
+        cache.insert(vftable, afterDesc, ::geode::geode_internal::TypeinfoCastCache::FAILED);
         return nullptr;
     }
 }
@@ -6,6 +6,7 @@
 #include <Geode/binding/FLAlertLayerProtocol.hpp>
 
 struct MDParser;
+class MDVirtualLayout;
 class CCScrollLayerExt;
 
 namespace geode {
@@ -60,6 +61,7 @@ namespace geode {
         void FLAlert_Clicked(FLAlertLayer*, bool btn) override;
 
         friend struct ::MDParser;
+        friend class ::MDVirtualLayout;
 
     public:
         /**
@@ -83,7 +85,9 @@ namespace geode {
 
         /**
          * Update the label's content; call
-         * sparingly as rendering may be slow
+         * sparingly as rendering may be slow.
+         * Long documents are only rendered
+         * where they're scrolled into view
          */
         void updateLabel();
 
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../DefaultInclude.hpp"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace geode::utils::thread {
+    /**
+     * A pool of worker threads that runs submitted jobs. Each worker has its
+     * own job queue; jobs submitted from a worker go to its own queue, and
+     * idle workers steal jobs from the queues of busy ones.
+     *
+     * An executor keeps a fixed set of core workers alive for its whole
+     * lifetime. If every worker is busy when a job is submitted, additional
+     * workers are started up to the executor's maximum; these exit again
+     * after they have been idle for a while. This keeps jobs that block
+     * (for example on network or disk IO) from starving everything else.
+     *
+     * `Task::run` uses the executor returned by `Executor::getDefault()`;
+     * use `Task::runOn` to run a Task on a different one
+     */
+    class GEODE_DLL Executor final {
+    public:
+        using Job = std::function<void()>;
+
+        struct Metrics {
+            /// Number of jobs waiting to be picked up by a worker
+            size_t queueDepth;
+            /// Number of workers currently running a job
+            size_t activeWorkers;
+            /// Number of workers currently alive, whether idle or not
+            size_t workers;
+            /// Number of jobs that have finished running
+            size_t completedJobs;
+            /// Average time between a job being submitted and it starting
+            std::chrono::nanoseconds averageLatency;
+            /// Longest time between a job being submitted and it starting
+            std::chrono::nanoseconds maxLatency;
+        };
+
+    private:
+        class Impl;
+        std::shared_ptr<Impl> m_impl;
+
+        Executor(std::string name, size_t coreWorkers, size_t maxWorkers, bool growWhenStarved = false);
+
+    public:
+        /**
+         * Create a new executor. Jobs still queued when the executor is
+         * destroyed are run before its workers exit
+         * @param name The name of the executor; used for naming its threads
+         * @param coreWorkers The number of workers that are always kept alive
+         * @param maxWorkers The maximum number of workers; 0 for no limit.
+         * Clamped to at least `coreWorkers`
+         */
+        static std::unique_ptr<Executor> create(std::string name, size_t coreWorkers, size_t maxWorkers = 0);
+
+        /**
+         * Get the loader-owned executor used by `Task::run`. Its core
+         * workers are sized to the hardware concurrency, and it starts more
+         * workers (up to four times as many) while all of them are busy.
+         *
+         * Jobs on this executor should not block for long; use
+         * `getBlocking()` (or `Task::runOn` with it) for anything that waits
+         * on network, disk or other jobs. If every worker does end up
+         * blocked while jobs are still queued, the executor goes past its
+         * limit and starts another worker after a short delay, so jobs
+         * waiting on queued jobs can't deadlock it, but they will stall
+         * everything else submitted in the meantime
+         */
+        static Executor* getDefault();
+
+        /**
+         * Get the loader-owned executor meant for jobs that spend most of
+         * their time blocked. It keeps no core workers and has no worker
+         * limit, but reuses idle workers instead of starting a new thread
+         * for every job
+         */
+        static Executor* getBlocking();
+
+        ~Executor();
+
+        Executor(Executor const&) = delete;
+        Executor& operator=(Executor const&) = delete;
+
+        /**
+         * Queue a job to be run on one of this executor's workers
+         */
+        void submit(Job job);
+
+        Metrics getMetrics() const;
+        std::string const& getName() const;
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "general.hpp"
+#include "Executor.hpp"
 #include "../loader/Event.hpp"
 #include "../loader/Loader.hpp"
 #include <mutex>
@@ -447,13 +448,25 @@ namespace geode {
          * Create a new Task with a function that returns the finished value.
          * See the class description for details about Tasks
          * @param body The body aka actual code of the Task. Note that this
-         * function MUST be synchronous - Task creates the thread for you!
+         * function MUST be synchronous - Task runs it on a worker thread for you!
          * @param name The name of the Task; used for debugging
          */
         static Task run(Run&& body, std::string_view name = "<Task>") {
+            return Task::runOn(utils::thread::Executor::getDefault(), std::move(body), name);
+        }
+        /**
+         * Create a new Task with a function that returns the finished value,
+         * running on a specific executor instead of the default one. Use
+         * this for Tasks that block for a long time (see
+         * `Executor::getBlocking`) or that need a dedicated set of threads
+         * @param executor The executor to run the body on
+         * @param body The body aka actual code of the Task. Note that this
+         * function MUST be synchronous - Task runs it on a worker thread for you!
+         * @param name The name of the Task; used for debugging
+         */
+        static Task runOn(utils::thread::Executor* executor, Run&& body, std::string_view name = "<Task>") {
             auto task = Task(Handle::create(name));
-            std::thread([handle = std::weak_ptr(task.m_handle), name = std::string(name), body = std::move(body)] {
-                utils::thread::setName(fmt::format("Task '{}'", name));
+            executor->submit([handle = std::weak_ptr(task.m_handle), body = std::move(body)] {
                 auto result = body(
                     [handle](P progress) {
                         Task::progress(handle.lock(), std::move(progress));
@@ -471,7 +484,7 @@ namespace geode {
                 else {
                     Task::finish(handle.lock(), std::move(*std::move(result).getValue()));
                 }
-            }).detach();
+            });
             return task;
         }
         /**
@@ -484,9 +497,20 @@ namespace geode {
          * @param name The name of the Task; used for debugging
          */
         static Task runWithCallback(RunWithCallback&& body, std::string_view name = "<Callback Task>") {
+            return Task::runWithCallbackOn(utils::thread::Executor::getDefault(), std::move(body), name);
+        }
+        /**
+         * Same as `runWithCallback`, but runs the body on a specific
+         * executor instead of the default one
+         * @param executor The executor to run the body on
+         * @param body The body aka actual code of the Task. The body may
+         * call its provided finish callback *exactly once* - subsequent
+         * calls will always be ignored
+         * @param name The name of the Task; used for debugging
+         */
+        static Task runWithCallbackOn(utils::thread::Executor* executor, RunWithCallback&& body, std::string_view name = "<Callback Task>") {
             auto task = Task(Handle::create(name));
-            std::thread([handle = std::weak_ptr(task.m_handle), name = std::string(name), body = std::move(body)] {
-                utils::thread::setName(fmt::format("Task '{}'", name));
+            executor->submit([handle = std::weak_ptr(task.m_handle), body = std::move(body)] {
                 body(
                     [handle](Result result) {
                         if (result.isCancelled()) {
@@ -506,7 +530,7 @@ namespace geode {
                         return !lock || lock->is(Status::Cancelled);
                     }
                 );
-            }).detach();
+            });
             return task;
         }
         /**
@@ -775,6 +775,35 @@ namespace geode::cocos {
      */
     GEODE_DLL cocos2d::CCNode* getChildByTagRecursive(cocos2d::CCNode* node, int tag);
 
+    /**
+     * A parsed CCNode::querySelector query. Parsing a query once and
+     * keeping it around avoids re-parsing it on every lookup
+     */
+    class GEODE_DLL NodeQuery final {
+    private:
+        class Impl;
+        std::shared_ptr<Impl> m_impl;
+
+        NodeQuery(std::shared_ptr<Impl> impl);
+
+    public:
+        /**
+         * Parse a query. See CCNode::querySelector for the supported syntax
+         * @param query The query to parse
+         * @returns The parsed query, or an error if the query is malformed
+         */
+        static Result<NodeQuery> parse(std::string_view query);
+
+        /**
+         * Find the first node matching this query
+         * @param root The node to start the search from
+         * @returns The first matching node, or nullptr if none was found
+         */
+        cocos2d::CCNode* match(cocos2d::CCNode* root) const;
+
+        std::string toString() const;
+    };
+
     /**
      *  Get first node that conforms to the predicate
      *  by traversing children recursively
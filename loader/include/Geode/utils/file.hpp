@@ -9,6 +9,7 @@
 #include <Geode/DefaultInclude.hpp>
 #include <Geode/utils/string.hpp>
 #include <filesystem>
+#include <span>
 #include <string>
 #include <unordered_set>
 
@@ -202,9 +203,17 @@ namespace geode::utils::file {
          */
         static Result<Unzip> create(ByteVector const& data);
 
+        /**
+         * Create unzipper for data in-memory without copying it
+         * @param data The zip's data. Must stay alive and unchanged for as
+         * long as the unzipper does
+         */
+        static Result<Unzip> create(std::span<uint8_t const> data);
+
         /**
          * Set a callback to be called with the progress of the unzip operation, first
-         * argument is the current entry, second argument is the total entries
+         * argument is the current entry, second argument is the total entries.
+         * The callback is always called on the thread calling extractAllTo
          * @note This is not thread-safe
          * @param callback Callback to call with the progress of the unzip operation
          */
@@ -229,11 +238,38 @@ namespace geode::utils::file {
          */
         bool hasEntry(Path const& name);
 
+        struct EntryInfo {
+            bool isDirectory;
+            /// Uncompressed size of the entry
+            uint64_t size;
+            /// CRC-32 of the uncompressed data, as stored in the zip
+            uint32_t crc32;
+        };
+
+        /**
+         * Get the info the zip's directory has on an entry, without
+         * extracting it
+         * @param name Entry path in zip
+         */
+        Result<EntryInfo> getEntryInfo(Path const& name) const;
+
         /**
          * Extract entry to memory
          * @param name Entry path in zip
          */
         Result<ByteVector> extract(Path const& name);
+        /**
+         * Get the data of an entry without copying it. Only works for entries
+         * stored without compression, in zips that are read from memory or
+         * from a file that could be memory-mapped; use `extract` otherwise
+         * @param name Entry path in zip
+         * @param verify Whether to check the data against the entry's CRC-32.
+         * Only skip this if the data gets checked some other way, like by
+         * hashing the whole zip
+         * @returns A view into the zip's data, valid for as long as the
+         * unzipper is alive
+         */
+        Result<std::span<uint8_t const>> view(Path const& name, bool verify = true) const;
         /**
          * Extract entry to file
          * @param name Entry path in zip
@@ -241,10 +277,21 @@ namespace geode::utils::file {
          */
         Result<> extractTo(Path const& name, Path const& path);
         /**
-         * Extract all entries to directory
+         * Extract all entries to directory. Larger archives are extracted on
+         * several threads, each with its own handle to the archive, and
+         * entries are streamed to disk in chunks rather than read into
+         * memory whole
          * @param dir Directory to unzip the contents to
          */
         Result<> extractAllTo(Path const& dir);
+        /**
+         * Extract some entries to directory. Directory entries are always
+         * created
+         * @param dir Directory to unzip the contents to
+         * @param filter Called with the path in zip of each file entry;
+         * return true to extract it
+         */
+        Result<> extractAllTo(Path const& dir, std::function<bool(Path const&)> filter);
 
         /**
          * Helper method for quickly unzipping a file
@@ -179,6 +179,25 @@ namespace geode::utils::web {
 
     using WebTask = Task<WebResponse, WebProgress>;
 
+    /**
+     * Limits for the connection pool shared by all WebRequests. All
+     * requests go through a single connection pool, so connections and TLS
+     * sessions to the same host are reused (and multiplexed over HTTP/2
+     * where possible) across requests
+     */
+    struct ConnectionLimits {
+        /// Maximum number of simultaneous connections to a single host;
+        /// requests above this wait for a connection to free up. 0 for no limit
+        size_t maxConnectionsPerHost = 6;
+        /// Maximum number of simultaneous connections in total. 0 for no limit
+        size_t maxConnections = 32;
+        /// Maximum number of idle connections kept open for reuse
+        size_t maxCachedConnections = 32;
+    };
+
+    GEODE_DLL ConnectionLimits getConnectionLimits();
+    GEODE_DLL void setConnectionLimits(ConnectionLimits const& limits);
+
     class GEODE_DLL WebRequest final {
     private:
         class Impl;
@@ -241,11 +260,69 @@ namespace geode::utils::web {
          * Sets the target byte range to request.
          * Defaults to receiving the full request.
          *
-         * @param byteRange a pair of ints, first value is what byte to start from, second value is the last byte to get (both inclusive)
+         * @param byteRange a pair of ints, first value is what byte to start from, second value is the last byte to get (both inclusive).
+         * Pass `std::numeric_limits<std::uint64_t>::max()` as the last byte to get everything from the first byte onwards
          * @return WebRequest&
          */
         WebRequest& downloadRange(std::pair<std::uint64_t, std::uint64_t> byteRange);
 
+        /**
+         * Writes the response body straight into a file as it is received,
+         * instead of keeping it in memory. The file is only written for
+         * successful (2xx) responses; other response bodies are still kept
+         * in memory so that `WebResponse::string` can be used for reporting
+         * errors. For successful responses, `WebResponse::data` is empty.
+         * The file is written on a background thread, and the request only
+         * finishes once it has been written and closed.
+         * Defaults to keeping the body in memory.
+         *
+         * @param path The file to write to; overwritten if it exists
+         * @return WebRequest&
+         */
+        WebRequest& downloadTo(std::filesystem::path const& path);
+
+        /**
+         * Sets a callback that receives the response body in chunks as it is
+         * received. Like `downloadTo`, only successful (2xx) response bodies
+         * are streamed, and `WebResponse::data` is empty for them. Can be
+         * combined with `downloadTo`.
+         * Note that the callback is called on the thread performing the
+         * transfer, not the main thread!
+         *
+         * @param callback Receives each chunk; return false to abort the
+         * request, which then fails
+         * @return WebRequest&
+         */
+        WebRequest& onChunk(std::function<bool(std::span<uint8_t const>)> callback);
+
+        /**
+         * Like `onChunk`, but the callback is called on a background thread
+         * instead of the one performing the transfer, so it can do slow work
+         * like writing to disk. Chunks are handed over in order, the transfer
+         * is paused while the callback falls behind, and the request only
+         * finishes once every chunk has been handled. If combined with
+         * `downloadTo`, each chunk is written to the file first.
+         *
+         * @param callback Receives each chunk; return false to abort the
+         * request, which then fails
+         * @return WebRequest&
+         */
+        WebRequest& onChunkAsync(std::function<bool(std::span<uint8_t const>)> callback);
+
+        /**
+         * Sets a callback that is called with the status code of a streamed
+         * (see `downloadTo` and `onChunk`) response right before its first
+         * chunk is written to the sinks. Useful for telling apart a partial
+         * (206) response to a `downloadRange` request from a server that
+         * ignored the range and sent the full (200) body.
+         * Like `onChunk`, called on the thread performing the transfer
+         *
+         * @param callback Receives the status code; return false to abort
+         * the request, which then fails
+         * @return WebRequest&
+         */
+        WebRequest& onStreamStart(std::function<bool(int)> callback);
+
         /**
          * Enable or disables peer verification in SSL handshake.
          * The default is true.
@@ -1,11 +1,12 @@
-#include <Geode/modify/Field.hpp>
 #include <Geode/utils/cocos.hpp>
 #include <Geode/modify/Field.hpp>
 #include <Geode/modify/CCNode.hpp>
 #include <Geode/utils/terminate.hpp>
 #include <cocos2d.h>
-#include <queue>
+#include <shared_mutex>
 #include <stack>
+#include <bit>
+#include <tuple>
 
 using namespace geode::prelude;
 using namespace geode::modifier;
@@ -13,8 +14,6 @@ using namespace geode::modifier;
 #pragma warning(push)
 #pragma warning(disable : 4273)
 
-constexpr auto METADATA_TAG = 0xB324ABC;
-
 struct ProxyCCNode;
 
 static uint64_t fnv1aHash(char const* str) {
@@ -37,16 +36,238 @@ public:
     }
 };
 
-class GeodeNodeMetadata final : public cocos2d::CCObject {
+struct StringHash {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view str) const {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+// Node IDs are interned, as the same handful of IDs get assigned to
+// thousands of nodes over a session. Nodes hold a pointer into this table,
+// which makes comparing IDs a pointer comparison. Interned IDs are never
+// freed so that the pointers stay valid; the set of distinct IDs in use
+// is small enough for that not to matter
+using NodeID = std::string const*;
+
+class NodeIDTable final {
 private:
+    std::unordered_set<std::string, StringHash, std::equal_to<>> m_ids;
+
+public:
+    static NodeIDTable* get() {
+        static auto inst = new NodeIDTable();
+        return inst;
+    }
+
+    NodeID intern(std::string_view id) {
+        if (id.empty()) return nullptr;
+        auto it = m_ids.find(id);
+        if (it == m_ids.end()) {
+            it = m_ids.emplace(id).first;
+        }
+        return &*it;
+    }
+
+    NodeID intern(std::string&& id) {
+        if (id.empty()) return nullptr;
+        auto it = m_ids.find(id);
+        if (it == m_ids.end()) {
+            it = m_ids.emplace(std::move(id)).first;
+        }
+        return &*it;
+    }
+
+    // nullptr if no node has ever had this ID, which means no node has it now
+    NodeID find(std::string_view id) const {
+        auto it = m_ids.find(id);
+        return it != m_ids.end() ? &*it : nullptr;
+    }
+};
+
+// only nodes with at least this many children get an ID index,
+// below it a linear scan is about as fast
+constexpr unsigned int CHILD_INDEX_THRESHOLD = 16;
+
+// Maps child IDs to children. Kept up to date by setID and the
+// addChild/removeChild hooks. The children array can also be modified
+// directly, which the index notices by the child count changing, and the
+// entries hold a reference so a child removed that way is never dangling
+class ChildIDIndex final {
+private:
+    struct Entry {
+        // null if the ID is shared, in which case the lookup has
+        // to scan to respect the child order
+        Ref<CCNode> child;
+        // the number of children with the ID
+        size_t count = 0;
+    };
+    std::unordered_map<NodeID, Entry> m_entries;
+    unsigned int m_childCount = 0;
+
+    void add(NodeID id, CCNode* child) {
+        if (!id) return;
+        auto& entry = m_entries[id];
+        entry.child = entry.count == 0 ? child : nullptr;
+        entry.count += 1;
+    }
+
+    void remove(NodeID id) {
+        if (!id) return;
+        auto it = m_entries.find(id);
+        if (it == m_entries.end()) return;
+        // the remaining child of a formerly shared ID isn't known
+        // without a scan, so the entry stays shared
+        it->second.count -= 1;
+        if (it->second.count == 0) {
+            m_entries.erase(it);
+        }
+    }
+
+public:
+    void rebuild(CCNode* parent, NodeID (*getID)(CCNode*)) {
+        m_entries.clear();
+        for (auto child : CCArrayExt<CCNode*>(parent->getChildren())) {
+            this->add(getID(child), child);
+        }
+        m_childCount = parent->getChildrenCount();
+    }
+
+    // false if the children array was modified without the hooks
+    bool isInSync(CCNode* parent) const {
+        return m_childCount == parent->getChildrenCount();
+    }
+
+    void childAdded(NodeID id, CCNode* child) {
+        m_childCount += 1;
+        this->add(id, child);
+    }
+
+    void childRemoved(NodeID id) {
+        m_childCount -= 1;
+        this->remove(id);
+    }
+
+    void rename(CCNode* child, NodeID from, NodeID to) {
+        this->remove(from);
+        this->add(to, child);
+    }
+
+    // The child with the ID, nullptr if there is none or
+    // nullopt if it's shared and the caller has to scan
+    std::optional<CCNode*> find(NodeID id) const {
+        auto it = m_entries.find(id);
+        if (it == m_entries.end()) {
+            return nullptr;
+        }
+        if (!it->second.child) {
+            return std::nullopt;
+        }
+        return it->second.child.data();
+    }
+};
+
+struct LayoutPart {
+    Ref<Layout> layout = nullptr;
+    Ref<LayoutOptions> options = nullptr;
+};
+
+struct UserObjectsPart {
+    std::unordered_map<std::string, Ref<CCObject>> objects;
+};
+
+struct EventListenersPart {
+    std::unordered_set<std::unique_ptr<EventListenerProtocol>> listeners;
+    std::unordered_map<std::string, std::unique_ptr<EventListenerProtocol>> idListeners;
+};
+
+namespace {
+    struct FieldInfo {
+        size_t offset;
+        size_t alignment;
+        FieldDestructor destructor;
+    };
+
+    struct FieldClassLayout {
+        size_t size = 0;
+        size_t fieldCount = 0;
+        // A new copy of the field infos is made whenever a field is
+        // registered. Arenas point into the copy that was current when they
+        // were created, so the old copies are never freed; there are only
+        // ever as many of them as there are Modify classes
+        std::vector<std::unique_ptr<FieldInfo[]>> versions;
+
+        FieldInfo const* fields() const {
+            return versions.back().get();
+        }
+    };
+}
+
+// m_fields can be used from any thread, so registering fields and creating
+// arenas (which reads the layouts) has to be synchronized. Everything else
+// only touches the arenas of a single node
+static std::shared_mutex s_fieldLayoutMutex;
+static std::unordered_map<std::string_view, size_t> s_fieldClassSlots;
+static std::vector<FieldClassLayout> s_fieldLayouts;
+
+// Contiguous storage for the fields of a single class on a single node.
+// Fields registered after the arena was allocated go to an overflow arena
+// linked through next. Only the header is read by mods
+struct FieldArena final : FieldArenaHeader {
+    size_t alignment;
+    FieldInfo const* fields;
+    FieldArena* next;
+
+    bool contains(size_t index) const {
+        return index - firstField < fieldCount;
+    }
+
+    std::byte* get(size_t offset) const {
+        return data + (offset - begin);
+    }
+};
+
+struct FieldContainersPart {
     // for performance reasons, this key is the hash of the class name
-    std::unordered_map<uint64_t, FieldContainer*, NoHashHasher<uint64_t>> m_classFieldContainers;
-    std::string m_id = "";
-    Ref<Layout> m_layout = nullptr;
-    Ref<LayoutOptions> m_layoutOptions = nullptr;
-    std::unordered_map<std::string, Ref<CCObject>> m_userObjects;
-    std::unordered_set<std::unique_ptr<EventListenerProtocol>> m_eventListeners;
-    std::unordered_map<std::string, std::unique_ptr<EventListenerProtocol>> m_idEventListeners;
+    std::unordered_map<uint64_t, FieldContainer*, NoHashHasher<uint64_t>> containers;
+
+    ~FieldContainersPart() {
+        for (auto& [_, container] : containers) {
+            delete container;
+        }
+    }
+};
+
+// the parts of the metadata most nodes never use, in the order of their bits.
+// They are destroyed in reverse, so the fields go first and can still use the
+// node's user objects and event listeners in their destructors
+using MetadataParts = std::tuple<
+    LayoutPart, UserObjectsPart, EventListenersPart, ChildIDIndex, FieldContainersPart
+>;
+
+template <class T, size_t I = 0>
+constexpr uint8_t metadataPartBit() {
+    if constexpr (std::is_same_v<T, std::tuple_element_t<I, MetadataParts>>) {
+        return 1 << I;
+    }
+    else {
+        return metadataPartBit<T, I + 1>();
+    }
+}
+
+// Every node that has an ID or any of the parts pays for one of these, so
+// it's kept to the CCObject base plus four pointer-sized members: 88 bytes
+// on 64-bit platforms, 68 on 32-bit ones. The field arenas are in the header
+// rather than a part so m_fields can find them inline. Each part that exists
+// adds a pointer to m_parts on top of the part itself
+class GeodeNodeMetadata final : public NodeMetadataHeader {
+private:
+    NodeID m_id = nullptr;
+    // which parts exist; the existing ones are stored in bit order in m_parts,
+    // so a node with just an ID doesn't pay for any of them
+    uint8_t m_partMask = 0;
+    std::unique_ptr<void*[]> m_parts;
 
     friend class ProxyCCNode;
     friend class cocos2d::CCNode;
@@ -54,41 +275,195 @@ private:
     GeodeNodeMetadata() {}
 
     virtual ~GeodeNodeMetadata() {
-        for (auto& [_, container] : m_classFieldContainers) {
-            delete container;
+        // the order matters: fields first, see MetadataParts
+        destroyFieldArenas(std::exchange(fieldArenas, nullptr));
+        this->destroyParts(std::make_index_sequence<std::tuple_size_v<MetadataParts>>());
+    }
+
+    static void destroyFieldArenas(std::vector<FieldArenaHeader*>* arenas);
+
+    size_t partPosition(uint8_t bit) const {
+        return std::popcount(static_cast<uint8_t>(m_partMask & (bit - 1)));
+    }
+
+    template <class T>
+    T* getPart() const {
+        constexpr auto bit = metadataPartBit<T>();
+        if (!(m_partMask & bit)) {
+            return nullptr;
         }
+        return static_cast<T*>(m_parts[this->partPosition(bit)]);
+    }
+
+    template <class T>
+    T& addPart() {
+        if (auto part = this->getPart<T>()) {
+            return *part;
+        }
+        constexpr auto bit = metadataPartBit<T>();
+        auto count = static_cast<size_t>(std::popcount(m_partMask));
+        auto pos = this->partPosition(bit);
+
+        auto parts = std::make_unique<void*[]>(count + 1);
+        std::copy_n(m_parts.get(), pos, parts.get());
+        std::copy_n(m_parts.get() + pos, count - pos, parts.get() + pos + 1);
+        auto part = new T();
+        parts[pos] = part;
+
+        m_parts = std::move(parts);
+        m_partMask |= bit;
+        return *part;
+    }
+
+    template <class T>
+    void removePart() {
+        auto part = this->getPart<T>();
+        if (!part) return;
+
+        constexpr auto bit = metadataPartBit<T>();
+        auto count = static_cast<size_t>(std::popcount(m_partMask));
+        auto pos = this->partPosition(bit);
+        std::copy(m_parts.get() + pos + 1, m_parts.get() + count, m_parts.get() + pos);
+        m_partMask &= ~bit;
+        delete part;
+    }
+
+    template <size_t... I>
+    void destroyParts(std::index_sequence<I...>) {
+        // detach the parts first, in case destroying one of them ends up
+        // looking at this node's metadata again
+        auto mask = std::exchange(m_partMask, 0);
+        auto parts = std::move(m_parts);
+        // in reverse bit order, see MetadataParts
+        constexpr auto count = sizeof...(I);
+        auto destroy = [&]<size_t J>() {
+            if (mask & (1 << J)) {
+                auto pos = std::popcount(static_cast<uint8_t>(mask & ((1 << J) - 1)));
+                delete static_cast<std::tuple_element_t<J, MetadataParts>*>(parts[pos]);
+            }
+        };
+        (destroy.template operator()<count - 1 - I>(), ...);
     }
 
 public:
+    // like set, but doesn't attach metadata to nodes that don't have it yet
+    static GeodeNodeMetadata* get(CCNode* target) {
+        if (!target) return nullptr;
+
+        auto obj = target->m_pUserObject;
+        if (obj && obj->getTag() == NODE_METADATA_TAG) {
+            return static_cast<GeodeNodeMetadata*>(obj);
+        }
+        return nullptr;
+    }
+
+    static NodeID getID(CCNode* target) {
+        auto meta = GeodeNodeMetadata::get(target);
+        return meta ? meta->m_id : nullptr;
+    }
+
+    static ChildIDIndex* getChildIndex(CCNode* target) {
+        auto meta = GeodeNodeMetadata::get(target);
+        return meta ? meta->getPart<ChildIDIndex>() : nullptr;
+    }
+
+    // the index holds a reference to its children, so this is safe
+    // to call on a stale entry
+    static bool isIndexedChild(CCNode* parent, CCNode* child, NodeID id) {
+        return child->getParent() == parent && GeodeNodeMetadata::getID(child) == id;
+    }
+
+    // The child with the ID, nullptr if there is none, or nullopt if the
+    // children have to be scanned instead. Lookups are read-only, so this
+    // never attaches metadata to the parent; nodes without any are scanned
+    static std::optional<CCNode*> findIndexedChild(CCNode* parent, NodeID id) {
+        if (parent->getChildrenCount() < CHILD_INDEX_THRESHOLD) {
+            return std::nullopt;
+        }
+        auto meta = GeodeNodeMetadata::get(parent);
+        if (!meta) {
+            return std::nullopt;
+        }
+        auto index = meta->getPart<ChildIDIndex>();
+        if (!index) {
+            index = &meta->addPart<ChildIDIndex>();
+            index->rebuild(parent, &GeodeNodeMetadata::getID);
+        }
+        else if (!index->isInSync(parent)) {
+            index->rebuild(parent, &GeodeNodeMetadata::getID);
+        }
+        auto found = index->find(id);
+        if (found && *found && !GeodeNodeMetadata::isIndexedChild(parent, *found, id)) {
+            index->rebuild(parent, &GeodeNodeMetadata::getID);
+            found = index->find(id);
+        }
+        return found;
+    }
+
+    // calls the visitor for every child with the given ID in child order,
+    // stopping at the first one it returns a node for. A null ID matches
+    // children without an ID
+    template <class F>
+    static CCNode* visitChildrenWithID(CCNode* parent, NodeID id, F&& visitor) {
+        if (!id) {
+            for (auto child : CCArrayExt<CCNode*>(parent->getChildren())) {
+                if (!GeodeNodeMetadata::getID(child)) {
+                    if (auto res = visitor(child)) {
+                        return res;
+                    }
+                }
+            }
+            return nullptr;
+        }
+        if (auto indexed = GeodeNodeMetadata::findIndexedChild(parent, id)) {
+            return *indexed ? visitor(*indexed) : nullptr;
+        }
+        for (auto child : CCArrayExt<CCNode*>(parent->getChildren())) {
+            if (GeodeNodeMetadata::getID(child) == id) {
+                if (auto res = visitor(child)) {
+                    return res;
+                }
+            }
+        }
+        return nullptr;
+    }
+
     static GeodeNodeMetadata* set(CCNode* target) {
         if (!target) return nullptr;
 
         auto old = target->m_pUserObject;
         // faster than dynamic_cast, technically can
         // but extremely unlikely to fail
-        if (old && old->getTag() == METADATA_TAG) {
+        if (old && old->getTag() == NODE_METADATA_TAG) {
             return static_cast<GeodeNodeMetadata*>(old);
         }
+        // the node owns the only reference, so there's no
+        // need to go through the autorelease pool
         auto meta = new GeodeNodeMetadata();
-        meta->autorelease();
-        meta->setTag(METADATA_TAG);
+        meta->setTag(NODE_METADATA_TAG);
 
         // set user object
         target->m_pUserObject = meta;
-        meta->retain();
 
         if (old) {
-            meta->m_userObjects.insert({ "", old });
+            meta->addPart<UserObjectsPart>().objects.insert({ "", old });
             // the old user object is now managed by Ref
             old->release();
         }
         return meta;
     }
 
+    std::vector<FieldArenaHeader*>& getFieldArenas() {
+        if (!fieldArenas) {
+            fieldArenas = new std::vector<FieldArenaHeader*>();
+        }
+        return *fieldArenas;
+    }
+
     FieldContainer* getFieldContainer(char const* forClass) {
         auto hash = fnv1aHash(forClass);
 
-        auto& container = m_classFieldContainers[hash];
+        auto& container = this->addPart<FieldContainersPart>().containers[hash];
         if (!container) {
             container = new FieldContainer();
         }
@@ -97,6 +472,11 @@ public:
     }
 };
 
+static_assert(
+    sizeof(GeodeNodeMetadata) == sizeof(CCObject) + 4 * sizeof(void*),
+    "GeodeNodeMetadata grew, anything most nodes don't need should be a part"
+);
+
 // proxy forwards
 #include <Geode/modify/CCNode.hpp>
 struct ProxyCCNode : Modify<ProxyCCNode, CCNode> {
@@ -120,6 +500,31 @@ struct ProxyCCNode : Modify<ProxyCCNode, CCNode> {
             CC_SAFE_RETAIN(m_pUserObject);
         }
     }
+
+    // keeping the child ID index in sync
+    virtual void addChild(CCNode* child, int zOrder, int tag) {
+        CCNode::addChild(child, zOrder, tag);
+        if (auto index = GeodeNodeMetadata::getChildIndex(this)) {
+            if (child && child->getParent() == this) {
+                index->childAdded(GeodeNodeMetadata::getID(child), child);
+            }
+        }
+    }
+    virtual void removeChild(CCNode* child, bool cleanup) {
+        // the child may be freed by the original, so this has to happen first
+        if (auto index = GeodeNodeMetadata::getChildIndex(this)) {
+            if (child && child->getParent() == this) {
+                index->childRemoved(GeodeNodeMetadata::getID(child));
+            }
+        }
+        CCNode::removeChild(child, cleanup);
+    }
+    virtual void removeAllChildrenWithCleanup(bool cleanup) {
+        if (auto meta = GeodeNodeMetadata::get(this)) {
+            meta->removePart<ChildIDIndex>();
+        }
+        CCNode::removeAllChildrenWithCleanup(cleanup);
+    }
 };
 
 // it is mostly safe to use string_view here to reduce heap allocations,
@@ -129,97 +534,201 @@ size_t modifier::getFieldIndexForClass(char const* name) {
 	return s_nextIndex[name]++;
 }
 
+FieldHandle modifier::registerField(
+    char const* forClass, size_t size, size_t alignment, FieldDestructor destructor
+) {
+    std::unique_lock lock(s_fieldLayoutMutex);
+    auto [it, inserted] = s_fieldClassSlots.try_emplace(forClass, s_fieldLayouts.size());
+    if (inserted) {
+        s_fieldLayouts.emplace_back();
+    }
+    auto& layout = s_fieldLayouts[it->second];
+
+    auto offset = (layout.size + alignment - 1) / alignment * alignment;
+    auto fields = std::make_unique<FieldInfo[]>(layout.fieldCount + 1);
+    if (layout.fieldCount > 0) {
+        std::copy_n(layout.fields(), layout.fieldCount, fields.get());
+    }
+    fields[layout.fieldCount] = { offset, alignment, destructor };
+    layout.versions.push_back(std::move(fields));
+    layout.fieldCount += 1;
+    layout.size = offset + size;
+
+    return { it->second, layout.fieldCount - 1, offset };
+}
+
+static FieldArena* createFieldArena(size_t classSlot, size_t firstField) {
+    std::shared_lock lock(s_fieldLayoutMutex);
+    auto& layout = s_fieldLayouts[classSlot];
+    auto fields = layout.fields();
+
+    size_t alignment = alignof(std::max_align_t);
+    for (auto i = firstField; i < layout.fieldCount; i++) {
+        alignment = std::max(alignment, fields[i].alignment);
+    }
+    // aligning the start down keeps every field at its natural
+    // alignment, since the offsets are aligned within the layout
+    auto begin = fields[firstField].offset / alignment * alignment;
+    auto fieldCount = layout.fieldCount - firstField;
+
+    // header, constructed flags and the fields themselves
+    // all share a single allocation
+    auto dataOffset = (sizeof(FieldArena) + fieldCount + alignment - 1) / alignment * alignment;
+    auto memory = static_cast<std::byte*>(
+        operator new(dataOffset + layout.size - begin, std::align_val_t(alignment))
+    );
+
+    auto arena = new (memory) FieldArena();
+    arena->firstField = firstField;
+    arena->fieldCount = fieldCount;
+    arena->begin = begin;
+    arena->alignment = alignment;
+    arena->fields = fields + firstField;
+    arena->next = nullptr;
+    arena->data = memory + dataOffset;
+    arena->constructed = reinterpret_cast<bool*>(memory + sizeof(FieldArena));
+    std::fill_n(arena->constructed, fieldCount, false);
+    return arena;
+}
+
+void GeodeNodeMetadata::destroyFieldArenas(std::vector<FieldArenaHeader*>* arenas) {
+    if (!arenas) return;
+    for (auto header : *arenas) {
+        auto arena = static_cast<FieldArena*>(header);
+        while (arena) {
+            for (size_t i = 0; i < arena->fieldCount; i++) {
+                if (arena->constructed[i]) {
+                    arena->fields[i].destructor(arena->get(arena->fields[i].offset));
+                }
+            }
+            auto next = arena->next;
+            auto alignment = arena->alignment;
+            arena->~FieldArena();
+            operator delete(static_cast<void*>(arena), std::align_val_t(alignment));
+            arena = next;
+        }
+    }
+    delete arenas;
+}
+
+void* modifier::getField(CCNode* node, FieldHandle const& handle, FieldConstructor constructor) {
+    auto& arenas = GeodeNodeMetadata::set(node)->getFieldArenas();
+    if (arenas.size() <= handle.classSlot) {
+        arenas.resize(handle.classSlot + 1, nullptr);
+    }
+
+    auto& head = arenas[handle.classSlot];
+    if (!head) {
+        head = createFieldArena(handle.classSlot, 0);
+    }
+    // fields registered after this node's arena was made end up in
+    // an overflow arena, which only happens once per node
+    auto arena = static_cast<FieldArena*>(head);
+    while (!arena->contains(handle.index)) {
+        if (!arena->next) {
+            arena->next = createFieldArena(handle.classSlot, arena->firstField + arena->fieldCount);
+        }
+        arena = arena->next;
+    }
+
+    // the arena holds the fields of every mod for this class,
+    // but they are only constructed once they are first used.
+    // After that, m_fields finds them without calling this
+    auto field = arena->get(handle.offset);
+    if (!arena->constructed[handle.index - arena->firstField]) {
+        constructor(field);
+        arena->constructed[handle.index - arena->firstField] = true;
+    }
+    return field;
+}
+
 FieldContainer* CCNode::getFieldContainer(char const* forClass) {
     return GeodeNodeMetadata::set(this)->getFieldContainer(forClass);
 }
 
 const std::string& CCNode::getID() {
-    return GeodeNodeMetadata::set(this)->m_id;
+    static std::string const empty;
+    auto id = GeodeNodeMetadata::getID(this);
+    return id ? *id : empty;
 }
 
 void CCNode::setID(std::string const& id) {
-    GeodeNodeMetadata::set(this)->m_id = id;
+    auto meta = GeodeNodeMetadata::set(this);
+    auto interned = NodeIDTable::get()->intern(std::string_view(id));
+    if (auto index = GeodeNodeMetadata::getChildIndex(m_pParent)) {
+        index->rename(this, meta->m_id, interned);
+    }
+    meta->m_id = interned;
 }
 
 void CCNode::setID(std::string&& id) {
-    GeodeNodeMetadata::set(this)->m_id = std::move(id);
+    auto meta = GeodeNodeMetadata::set(this);
+    auto interned = NodeIDTable::get()->intern(std::move(id));
+    if (auto index = GeodeNodeMetadata::getChildIndex(m_pParent)) {
+        index->rename(this, meta->m_id, interned);
+    }
+    meta->m_id = interned;
 }
 
 CCNode* CCNode::getChildByID(std::string_view id) {
-    for (auto child : CCArrayExt<CCNode*>(this->getChildren())) {
-        if (child->getID() == id) {
-            return child;
-        }
+    auto interned = NodeIDTable::get()->find(id);
+    if (!interned && !id.empty()) {
+        return nullptr;
     }
-    return nullptr;
+    return GeodeNodeMetadata::visitChildrenWithID(this, interned, [](CCNode* child) {
+        return child;
+    });
 }
 
-CCNode* CCNode::getChildByIDRecursive(std::string_view id) {
-    if (auto child = this->getChildByID(id)) {
+static CCNode* getChildByIDRecursive(CCNode* node, NodeID id) {
+    auto child = GeodeNodeMetadata::visitChildrenWithID(node, id, [](CCNode* child) {
+        return child;
+    });
+    if (child) {
         return child;
     }
-    for (auto child : CCArrayExt<CCNode*>(m_pChildren)) {
-        if ((child = child->getChildByIDRecursive(id))) {
+    for (auto child : CCArrayExt<CCNode*>(node->getChildren())) {
+        if ((child = getChildByIDRecursive(child, id))) {
             return child;
         }
     }
     return nullptr;
 }
 
-class BFSNodeTreeCrawler final {
-private:
-    std::queue<CCNode*> m_queue;
-    std::unordered_set<CCNode*> m_explored;
-
-public:
-    BFSNodeTreeCrawler(CCNode* target) {
-        if (auto first = getChild(target, 0)) {
-            m_explored.insert(first);
-            m_queue.push(first);
-        }
-    }
-
-    CCNode* next() {
-        if (m_queue.empty()) {
-            return nullptr;
-        }
-        auto node = m_queue.front();
-        m_queue.pop();
-        for (auto sibling : CCArrayExt<CCNode*>(node->getParent()->getChildren())) {
-            if (!m_explored.contains(sibling)) {
-                m_explored.insert(sibling);
-                m_queue.push(sibling);
-            }
-        }
-        for (auto child : CCArrayExt<CCNode*>(node->getChildren())) {
-            if (!m_explored.contains(child)) {
-                m_explored.insert(child);
-                m_queue.push(child);
-            }
-        }
-        return node;
+CCNode* CCNode::getChildByIDRecursive(std::string_view id) {
+    auto interned = NodeIDTable::get()->find(id);
+    if (!interned && !id.empty()) {
+        return nullptr;
     }
-};
+    return ::getChildByIDRecursive(this, interned);
+}
 
-class NodeQuery final {
-private:
+class NodeQuery::Impl final {
+public:
     enum class Op {
         ImmediateChild,
         DescendantChild,
     };
 
-    std::string m_targetID;
-    Op m_nextOp;
-    std::unique_ptr<NodeQuery> m_next = nullptr;
+    struct Part {
+        std::string targetID;
+        // resolved on first match, as IDs don't get interned until
+        // some node actually uses them
+        mutable NodeID internedID = nullptr;
+        // how the next part relates to this one
+        Op nextOp = Op::DescendantChild;
+    };
 
-public:
-    static Result<std::unique_ptr<NodeQuery>> parse(std::string_view query) {
+    // the first part always has an empty ID, as it matches the root
+    std::vector<Part> m_parts;
+
+    static Result<std::shared_ptr<Impl>> parse(std::string_view query) {
         if (query.empty()) {
             return Err("Query may not be empty");
         }
 
-        auto result = std::make_unique<NodeQuery>();
-        NodeQuery* current = result.get();
+        auto result = std::make_shared<Impl>();
+        result->m_parts.emplace_back();
 
         size_t i = 0;
         std::string collectedID;
@@ -243,11 +752,10 @@ public:
             // ID-valid characters
             else if (std::isalnum(c) || c == '-' || c == '_' || c == '/' || c == '.') {
                 if (nextOp) {
-                    current->m_next = std::make_unique<NodeQuery>();
-                    current->m_nextOp = *nextOp;
-                    current->m_targetID = collectedID;
-                    current = current->m_next.get();
-
+                    auto& current = result->m_parts.back();
+                    current.nextOp = *nextOp;
+                    current.targetID = std::move(collectedID);
+                    result->m_parts.emplace_back();
                     collectedID = "";
                     nextOp = std::nullopt;
                 }
@@ -263,63 +771,131 @@ public:
         if (nextOp || collectedID.empty()) {
             return Err("Expected node ID but got end of query");
         }
-        current->m_targetID = collectedID;
+        result->m_parts.back().targetID = std::move(collectedID);
 
         return Ok(std::move(result));
     }
 
-    CCNode* match(CCNode* node) const {
+    // calls the visitor for the children of the parent that could match
+    // the given part, using the ID index when the part has an ID
+    template <class F>
+    static CCNode* visitCandidates(CCNode* parent, Part const& part, F&& visitor) {
+        if (part.internedID) {
+            return GeodeNodeMetadata::visitChildrenWithID(parent, part.internedID, visitor);
+        }
+        for (auto child : CCArrayExt<CCNode*>(parent->getChildren())) {
+            if (auto res = visitor(child)) {
+                return res;
+            }
+        }
+        return nullptr;
+    }
+
+    CCNode* match(CCNode* node, size_t index) const {
+        auto& part = m_parts[index];
+
         // Make sure this matches the ID being looked for
-        if (!m_targetID.empty() && node->getID() != m_targetID) {
+        if (part.internedID && GeodeNodeMetadata::getID(node) != part.internedID) {
             return nullptr;
         }
+
         // If this is the last thing to match, return the result
-        if (!m_next) {
+        if (index + 1 == m_parts.size()) {
             return node;
         }
-        switch (m_nextOp) {
+
+        auto& next = m_parts[index + 1];
+        auto matchNext = [&](CCNode* child) {
+            return this->match(child, index + 1);
+        };
+        switch (part.nextOp) {
             case Op::ImmediateChild: {
-                for (auto c : CCArrayExt<CCNode*>(node->getChildren())) {
-                    if (auto r = m_next->match(c)) {
-                        return r;
-                    }
-                }
+                return visitCandidates(node, next, matchNext);
             } break;
 
             case Op::DescendantChild: {
-                auto crawler = BFSNodeTreeCrawler(node);
-                while (auto c = crawler.next()) {
-                    if (auto r = m_next->match(c)) {
+                // breadth-first, visiting the candidates among each
+                // node's children before moving on to the next level
+                std::vector<CCNode*> queue { node };
+                for (size_t head = 0; head < queue.size(); head += 1) {
+                    auto parent = queue[head];
+                    if (auto r = visitCandidates(parent, next, matchNext)) {
                         return r;
                     }
+                    for (auto child : CCArrayExt<CCNode*>(parent->getChildren())) {
+                        queue.push_back(child);
+                    }
                 }
             } break;
         }
         return nullptr;
     }
 
+    // false if some part's ID isn't used by any node, so nothing can match
+    bool resolveIDs() const {
+        for (auto& part : m_parts) {
+            if (!part.internedID && !part.targetID.empty()) {
+                part.internedID = NodeIDTable::get()->find(part.targetID);
+                if (!part.internedID) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
     std::string toString() const {
-        auto str = m_targetID.empty() ? "&" : m_targetID;
-        if (m_next) {
-            switch (m_nextOp) {
-                case Op::ImmediateChild: str += " > "; break;
-                case Op::DescendantChild: str += " "; break;
+        std::string str;
+        for (size_t i = 0; i < m_parts.size(); i += 1) {
+            if (i != 0) {
+                switch (m_parts[i - 1].nextOp) {
+                    case Op::ImmediateChild: str += " > "; break;
+                    case Op::DescendantChild: str += " "; break;
+                }
             }
-            str += m_next->toString();
+            str += m_parts[i].targetID.empty() ? "&" : m_parts[i].targetID;
         }
         return str;
     }
 };
 
-CCNode* CCNode::querySelector(std::string_view queryStr) {
-    auto res = NodeQuery::parse(queryStr);
-    if (!res) {
-        log::error("Invalid CCNode::querySelector query '{}': {}", queryStr, res.unwrapErr());
+NodeQuery::NodeQuery(std::shared_ptr<Impl> impl) : m_impl(std::move(impl)) {}
+
+Result<NodeQuery> NodeQuery::parse(std::string_view query) {
+    GEODE_UNWRAP_INTO(auto impl, Impl::parse(query));
+    return Ok(NodeQuery(std::move(impl)));
+}
+
+CCNode* NodeQuery::match(CCNode* root) const {
+    if (!root || !m_impl->resolveIDs()) {
         return nullptr;
     }
-    auto query = std::move(res.unwrap());
-    // log::info("parsed query: {}", query->toString());
-    return query->match(this);
+    return m_impl->match(root, 0);
+}
+
+std::string NodeQuery::toString() const {
+    return m_impl->toString();
+}
+
+// mods tend to use the same handful of literal queries over and over
+constexpr size_t MAX_CACHED_QUERIES = 128;
+static std::unordered_map<std::string, NodeQuery, StringHash, std::equal_to<>> s_queryCache;
+
+CCNode* CCNode::querySelector(std::string_view queryStr) {
+    auto it = s_queryCache.find(queryStr);
+    if (it == s_queryCache.end()) {
+        auto res = NodeQuery::parse(queryStr);
+        if (!res) {
+            log::error("Invalid CCNode::querySelector query '{}': {}", queryStr, res.unwrapErr());
+            return nullptr;
+        }
+        if (s_queryCache.size() >= MAX_CACHED_QUERIES) {
+            s_queryCache.clear();
+        }
+        it = s_queryCache.emplace(std::string(queryStr), std::move(res.unwrap())).first;
+    }
+    // log::info("parsed query: {}", it->second.toString());
+    return it->second.match(this);
 }
 
 void CCNode::removeChildByID(std::string_view id) {
@@ -335,32 +911,36 @@ void CCNode::setLayout(Layout* layout, bool apply, bool respectAnchor) {
         }
         this->ignoreAnchorPointForPosition(false);
     }
-    GeodeNodeMetadata::set(this)->m_layout = layout;
+    GeodeNodeMetadata::set(this)->addPart<LayoutPart>().layout = layout;
     if (apply) {
         this->updateLayout();
     }
 }
 
 Layout* CCNode::getLayout() {
-    return GeodeNodeMetadata::set(this)->m_layout.data();
+    auto meta = GeodeNodeMetadata::get(this);
+    auto part = meta ? meta->getPart<LayoutPart>() : nullptr;
+    return part ? part->layout.data() : nullptr;
 }
 
 void CCNode::setLayoutOptions(LayoutOptions* options, bool apply) {
-    GeodeNodeMetadata::set(this)->m_layoutOptions = options;
+    GeodeNodeMetadata::set(this)->addPart<LayoutPart>().options = options;
     if (apply && m_pParent) {
         m_pParent->updateLayout();
     }
 }
 
 LayoutOptions* CCNode::getLayoutOptions() {
-    return GeodeNodeMetadata::set(this)->m_layoutOptions.data();
+    auto meta = GeodeNodeMetadata::get(this);
+    auto part = meta ? meta->getPart<LayoutPart>() : nullptr;
+    return part ? part->options.data() : nullptr;
 }
 
 void CCNode::updateLayout(bool updateChildOrder) {
     if (updateChildOrder && m_pChildren) {
         this->sortAllChildren();
     }
-    if (auto layout = GeodeNodeMetadata::set(this)->m_layout.data()) {
+    if (auto layout = this->getLayout()) {
         layout->apply(this);
     }
 }
@@ -378,67 +958,85 @@ ListenerResult AttributeSetFilter::handle(std::function<Callback> fn, UserObject
 AttributeSetFilter::AttributeSetFilter(std::string const& id) : m_targetID(id) {}
 
 void CCNode::setUserObject(std::string const& id, CCObject* value) {
-    auto meta = GeodeNodeMetadata::set(this);
     if (value) {
-        meta->m_userObjects[id] = value;
+        GeodeNodeMetadata::set(this)->addPart<UserObjectsPart>().objects[id] = value;
     }
-    else {
-        meta->m_userObjects.erase(id);
+    else if (auto meta = GeodeNodeMetadata::get(this)) {
+        if (auto part = meta->getPart<UserObjectsPart>()) {
+            part->objects.erase(id);
+        }
+    }
+    else if (id.empty() && m_pUserObject) {
+        // a user object set without going through the hooks
+        CC_SAFE_RELEASE_NULL(m_pUserObject);
     }
     UserObjectSetEvent(this, id, value).post();
 }
 
 CCObject* CCNode::getUserObject(std::string const& id) {
-    auto meta = GeodeNodeMetadata::set(this);
-    if (meta->m_userObjects.count(id)) {
-        return meta->m_userObjects.at(id);
+    auto meta = GeodeNodeMetadata::get(this);
+    if (!meta) {
+        // without metadata, whatever is in the slot is the default user object
+        return id.empty() ? m_pUserObject : nullptr;
+    }
+    auto part = meta->getPart<UserObjectsPart>();
+    if (part && part->objects.count(id)) {
+        return part->objects.at(id);
     }
     return nullptr;
 }
 
 void CCNode::addEventListenerInternal(std::string const& id, EventListenerProtocol* listener) {
-    auto meta = GeodeNodeMetadata::set(this);
+    auto& part = GeodeNodeMetadata::set(this)->addPart<EventListenersPart>();
     if (id.size()) {
-        if (meta->m_idEventListeners.contains(id)) {
-            meta->m_idEventListeners.at(id).reset(listener);
+        if (part.idListeners.contains(id)) {
+            part.idListeners.at(id).reset(listener);
         }
         else {
-            meta->m_idEventListeners.emplace(id, listener);
+            part.idListeners.emplace(id, listener);
         }
     }
     else {
-        std::erase_if(meta->m_eventListeners, [=](auto& l) {
+        std::erase_if(part.listeners, [=](auto& l) {
             return l.get() == listener;
         });
-        meta->m_eventListeners.emplace(listener);
+        part.listeners.emplace(listener);
     }
 }
 
+static EventListenersPart* getEventListenersPart(CCNode* node) {
+    auto meta = GeodeNodeMetadata::get(node);
+    return meta ? meta->getPart<EventListenersPart>() : nullptr;
+}
+
 void CCNode::removeEventListener(EventListenerProtocol* listener) {
-    auto meta = GeodeNodeMetadata::set(this);
-    std::erase_if(meta->m_eventListeners, [=](auto& l) {
+    auto part = getEventListenersPart(this);
+    if (!part) return;
+    std::erase_if(part->listeners, [=](auto& l) {
         return l.get() == listener;
     });
-    std::erase_if(meta->m_idEventListeners, [=](auto& l) {
+    std::erase_if(part->idListeners, [=](auto& l) {
         return l.second.get() == listener;
     });
 }
 
 void CCNode::removeEventListener(std::string const& id) {
-    GeodeNodeMetadata::set(this)->m_idEventListeners.erase(id);
+    if (auto part = getEventListenersPart(this)) {
+        part->idListeners.erase(id);
+    }
 }
 
 EventListenerProtocol* CCNode::getEventListener(std::string const& id) {
-    auto meta = GeodeNodeMetadata::set(this);
-    if (meta->m_idEventListeners.contains(id)) {
-        return meta->m_idEventListeners.at(id).get();
+    auto part = getEventListenersPart(this);
+    if (part && part->idListeners.contains(id)) {
+        return part->idListeners.at(id).get();
     }
     return nullptr;
 }
 
 size_t CCNode::getEventListenerCount() {
-    return GeodeNodeMetadata::set(this)->m_idEventListeners.size() +
-        GeodeNodeMetadata::set(this)->m_eventListeners.size();
+    auto part = getEventListenersPart(this);
+    return part ? part->idListeners.size() + part->listeners.size() : 0;
 }
 
 void CCNode::addChildAtPosition(CCNode* child, Anchor anchor, CCPoint const& offset, bool useAnchorLayout) {
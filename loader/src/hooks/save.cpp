@@ -1,4 +1,6 @@
 #include <Geode/loader/Loader.hpp>
+#include <loader/LoaderImpl.hpp>
+#include <loader/SaveWriter.hpp>
 
 using namespace geode::prelude;
 
@@ -12,19 +14,28 @@ namespace {
 
         auto begin = std::chrono::high_resolution_clock::now();
 
-        (void)Loader::get()->saveData();
+        // Files are written out in the background while the game saves its
+        // own data, see flushModData
+        LoaderImpl::get()->saveData();
 
         auto end = std::chrono::high_resolution_clock::now();
         auto time = std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
         log::info("Took {}s", static_cast<float>(time) / 1000.f);
     }
+
+    void flushModData() {
+        // The game may quit right after saving, so all of the files have to
+        // be written before returning
+        SaveWriter::get()->flush();
+    }
 }
 
 struct SaveLoader : Modify<SaveLoader, AppDelegate> {
     GEODE_FORWARD_COMPAT_DISABLE_HOOKS("save moved to CCApplication::gameDidSave()")
     void trySaveGame(bool p0) {
         saveModData();
-        return AppDelegate::trySaveGame(p0);
+        AppDelegate::trySaveGame(p0);
+        flushModData();
     }
 };
 
@@ -34,7 +45,8 @@ struct FallbackSaveLoader : Modify<FallbackSaveLoader, CCApplication> {
     GEODE_FORWARD_COMPAT_ENABLE_HOOKS("")
     void gameDidSave() {
         saveModData();
-        return CCApplication::gameDidSave();
+        CCApplication::gameDidSave();
+        flushModData();
     }
 };
 
@@ -2,6 +2,7 @@
 #include <fmt/core.h>
 #include "about.hpp"
 #include "../loader/ModImpl.hpp"
+#include "../loader/LogImpl.hpp"
 #include <Geode/Utils.hpp>
 
 using namespace geode::prelude;
@@ -60,6 +61,9 @@ std::string crashlog::writeCrashlog(geode::Mod* faultyMod, std::string const& in
 }
 
 std::string crashlog::writeCrashlog(geode::Mod* faultyMod, std::string const& info, std::string const& stacktrace, std::string const& registers, std::filesystem::path& outPath) {
+    // get whatever is still waiting to be logged into the log file
+    log::Logger::get()->flush();
+
     // make sure crashlog directory exists
     (void)utils::file::createDirectoryAll(crashlog::getCrashLogDirectory());
 
@@ -0,0 +1,70 @@
+#ifdef GEODE_INTERNAL_TESTS
+
+#include <Geode/loader/Log.hpp>
+#include <Geode/loader/Mod.hpp>
+#include <server/CacheMap.hpp>
+#include "InternalTest.hpp"
+#include <memory>
+
+using namespace geode::prelude;
+using namespace server;
+
+namespace {
+    constexpr test::InternalTest cacheMapTest("CacheMap");
+
+    // Shared so that the test can finish "requests" after adding them
+    struct FakeValue {
+        std::shared_ptr<CacheEntrySize> size;
+    };
+    struct FakeValueSize {
+        CacheEntrySize operator()(FakeValue& value) const {
+            return *value.size;
+        }
+    };
+    using FakeCache = CacheMap<int, FakeValue, FakeValueSize>;
+
+    FakeValue fake(size_t bytes, bool final = true) {
+        return FakeValue { std::make_shared<CacheEntrySize>(CacheEntrySize { bytes, final }) };
+    }
+}
+
+$on_mod(Loaded) {
+    FakeCache cache;
+    cacheMapTest.expect(cache.limit(100) == 0, "limiting an empty cache evicted something");
+
+    cacheMapTest.expect(cache.add(1, fake(40)) == 0, "evicted while under the limit");
+    cacheMapTest.expect(cache.add(2, fake(40)) == 0, "evicted while under the limit");
+    cacheMapTest.expect(cache.bytes() == 80, "byte count doesn't match after adding");
+
+    // 1 is now the most recently used, so 2 goes first
+    cacheMapTest.expect(cache.get(1).has_value(), "missing an item that was just added");
+    cacheMapTest.expect(cache.add(3, fake(40)) == 1, "didn't evict exactly one item when over the limit");
+    cacheMapTest.expect(!cache.get(2).has_value(), "evicted the wrong item");
+    cacheMapTest.expect(cache.get(1).has_value() && cache.get(3).has_value(), "evicted a recently used item");
+    cacheMapTest.expect(cache.bytes() == 80, "byte count doesn't match after evicting");
+
+    cache.remove(1);
+    cacheMapTest.expect(cache.size() == 1 && cache.bytes() == 40, "byte count doesn't match after removing");
+
+    // the most recently used item is kept even if it's over the limit alone
+    cacheMapTest.expect(cache.add(4, fake(500)) == 1, "didn't evict everything else for an oversized item");
+    cacheMapTest.expect(cache.size() == 1 && cache.get(4).has_value(), "evicted an oversized item");
+    cacheMapTest.expect(cache.bytes() == 500, "byte count doesn't match after an oversized item");
+
+    // unfinished values get sized again once they have finished
+    cache.limit(1000);
+    auto pending = fake(10, false);
+    cache.add(5, FakeValue(pending));
+    cacheMapTest.expect(cache.bytes() == 510, "byte count doesn't match with an unfinished item");
+    *pending.size = CacheEntrySize { 600, true };
+    cacheMapTest.expect(cache.add(6, fake(10)) == 1, "didn't evict after an item grew past the limit");
+    cacheMapTest.expect(cache.bytes() == 610, "byte count doesn't match after an item was sized again");
+
+    cacheMapTest.expect(cache.limit(5) == 1, "didn't evict down to the most recent item on a smaller limit");
+    cacheMapTest.expect(cache.size() == 1 && cache.bytes() == 10, "byte count doesn't match after lowering the limit");
+
+    cache.clear();
+    cacheMapTest.expect(cache.size() == 0 && cache.bytes() == 0, "not empty after clearing");
+}
+
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Geode/loader/Log.hpp>
+#include <string_view>
+
+// Tests of loader code that isn't exported. Everything reachable through the
+// public headers is tested by the test mod in test/main instead, but these
+// need the loader's internals, so they are compiled into the loader itself
+// when building with GEODE_BUILD_INTERNAL_TESTS and run when it loads. Every
+// internal test goes through this, so a failure always logs the same way
+namespace geode::test {
+    class InternalTest final {
+    private:
+        std::string_view m_name;
+
+    public:
+        constexpr InternalTest(std::string_view name) : m_name(name) {}
+
+        void fail(std::string_view what) const {
+            log::error("{} test failed: {}", m_name, what);
+        }
+
+        void expect(bool condition, std::string_view what) const {
+            if (!condition) {
+                this->fail(what);
+            }
+        }
+    };
+}
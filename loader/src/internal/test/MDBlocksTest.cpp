@@ -0,0 +1,141 @@
+#ifdef GEODE_INTERNAL_TESTS
+
+#include <Geode/loader/Log.hpp>
+#include <Geode/loader/Mod.hpp>
+#include <Geode/modify/MenuLayer.hpp>
+#include <Geode/ui/MDTextArea.hpp>
+#include <ui/nodes/MDBlocks.hpp>
+#include "InternalTest.hpp"
+#include <chrono>
+
+using namespace geode::prelude;
+
+namespace {
+    constexpr test::InternalTest mdBlocksTest("Markdown block");
+
+    void expectBlocks(std::string_view text, std::vector<std::string> const& expected, std::string_view what) {
+        auto blocks = splitMarkdownBlocks(text);
+        if (blocks != expected) {
+            mdBlocksTest.fail(fmt::format("{}: expected {} blocks, got {}", what, expected.size(), blocks.size()));
+        }
+    }
+
+    size_t countNodes(CCNode* node) {
+        size_t count = 1;
+        for (auto child : CCArrayExt<CCNode*>(node->getChildren())) {
+            count += countNodes(child);
+        }
+        return count;
+    }
+}
+
+$on_mod(Loaded) {
+    expectBlocks("", {}, "empty document");
+    expectBlocks(
+        "# Title\n\nFirst paragraph\nstill first\n\nSecond",
+        { "# Title\n\n", "First paragraph\nstill first\n\n", "Second\n" },
+        "paragraphs"
+    );
+
+    // blank lines in a fence don't end it, and only a fence of the same kind
+    // that is at least as long closes it
+    expectBlocks(
+        "a\n\n```cpp\nint x;\n\nint y;\n```\n\nb\n",
+        { "a\n\n", "```cpp\nint x;\n\nint y;\n```\n\n", "b\n" },
+        "backtick fence"
+    );
+    expectBlocks(
+        "~~~~\n```\n\n~~~\n\nstill code\n~~~~\n\nafter\n",
+        { "~~~~\n```\n\n~~~\n\nstill code\n~~~~\n\n", "after\n" },
+        "tilde fence with shorter fences inside"
+    );
+    expectBlocks(
+        "a\n\n```\nnever closed\n\nb\n",
+        { "a\n\n", "```\nnever closed\n\nb\n" },
+        "unclosed fence"
+    );
+
+    // list items separated by blank lines are one loose list, and indented
+    // lines belong to the item above them
+    expectBlocks(
+        "- one\n\n- two\n\n  more of two\n\n* three\n\nafter\n",
+        { "- one\n\n- two\n\n  more of two\n\n* three\n\n", "after\n" },
+        "bullet list"
+    );
+    expectBlocks(
+        "1. one\n\n2) two\n\n10. ten\n\n2024 was a year\n",
+        { "1. one\n\n2) two\n\n10. ten\n\n", "2024 was a year\n" },
+        "ordered list"
+    );
+    expectBlocks(
+        "a\n\n-not a list\n",
+        { "a\n\n", "-not a list\n" },
+        "list marker without a space"
+    );
+
+    // link reference definitions apply to the whole document, so it can't
+    // be split, unless the definition is really code
+    mdBlocksTest.expect(splitMarkdownBlocks("See [the docs][docs]\n\n[docs]: https://docs.geode-sdk.org\n").empty(), "link reference definition");
+    mdBlocksTest.expect(splitMarkdownBlocks("a\n\n   [docs]: https://docs.geode-sdk.org\n").empty(), "indented link reference definition");
+    expectBlocks(
+        "```\n[docs]: https://docs.geode-sdk.org\n```\n\nb\n",
+        { "```\n[docs]: https://docs.geode-sdk.org\n```\n\n", "b\n" },
+        "link reference definition in a fence"
+    );
+    expectBlocks(
+        "a\n\n    [docs]: https://docs.geode-sdk.org\n",
+        { "a\n\n    [docs]: https://docs.geode-sdk.org\n" },
+        "link reference definition in indented code"
+    );
+    expectBlocks(
+        "A [link](https://geode-sdk.org) and [another] one\n",
+        { "A [link](https://geode-sdk.org) and [another] one\n" },
+        "inline links"
+    );
+}
+
+// Rendering needs the loader's fonts, which are only loaded once the game
+// gets to the menu
+class $modify(MDBlocksTestLayer, MenuLayer) {
+    bool init() {
+        if (!MenuLayer::init())
+            return false;
+
+        static bool measured = false;
+        if (measured) return true;
+        measured = true;
+
+        // Roughly the shape of a long changelog, at 5 lines per version
+        std::string changelog;
+        for (size_t i = 1000; i > 0; i--) {
+            changelog += fmt::format(
+                "## v1.{}.0\n\n- Fixed `something` in [the editor](https://geode-sdk.org)\n- Added <cg>{}</c> things\n\n",
+                i, i
+            );
+        }
+        auto blocks = splitMarkdownBlocks(changelog);
+        mdBlocksTest.expect(blocks.size() == 1000, "wrong number of blocks in the changelog");
+
+        // A link reference definition makes the text area render everything,
+        // like it does for every document before virtualization
+        auto measure = [](std::string const& text) {
+            auto start = std::chrono::steady_clock::now();
+            Ref area = MDTextArea::create(text, { 300.f, 200.f });
+            auto time = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start
+            );
+            return std::make_pair(countNodes(area), time.count() / 1000.f);
+        };
+        auto [virtualNodes, virtualTime] = measure(changelog);
+        auto [wholeNodes, wholeTime] = measure(changelog + "\n[unused]: https://geode-sdk.org\n");
+        log::info(
+            "5000 line changelog: {} blocks, {} nodes in {:.2f}ms when virtualized, {} nodes in {:.2f}ms whole",
+            blocks.size(), virtualNodes, virtualTime, wholeNodes, wholeTime
+        );
+        mdBlocksTest.expect(virtualNodes < wholeNodes, "virtualizing didn't create fewer nodes");
+
+        return true;
+    }
+};
+
+#endif
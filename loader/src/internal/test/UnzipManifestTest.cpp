@@ -0,0 +1,82 @@
+#ifdef GEODE_INTERNAL_TESTS
+
+#include <Geode/loader/Dirs.hpp>
+#include <Geode/loader/Log.hpp>
+#include <Geode/loader/Mod.hpp>
+#include <Geode/utils/file.hpp>
+#include <loader/UnzipManifest.hpp>
+#include "InternalTest.hpp"
+
+using namespace geode::prelude;
+
+namespace {
+    constexpr test::InternalTest unzipManifestTest("Unzip manifest");
+
+    void writeFile(std::filesystem::path const& path, std::string const& contents) {
+        (void)file::createDirectoryAll(path.parent_path());
+        if (auto res = file::writeString(path, contents); !res) {
+            unzipManifestTest.fail(fmt::format("couldn't write {}: {}", path, res.unwrapErr()));
+        }
+    }
+}
+
+$on_mod(Loaded) {
+    auto dir = dirs::getTempDir() / "unzip-manifest-test";
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+
+    // what the last unzip extracted
+    UnzipManifest previous {
+        { "mod.json", { .crc32 = 1, .size = 4 } },
+        { "resources/same.png", { .crc32 = 2, .size = 4 } },
+        { "resources/edited.png", { .crc32 = 3, .size = 4 } },
+        { "resources/truncated.png", { .crc32 = 4, .size = 4 } },
+        { "resources/removed/old.png", { .crc32 = 5, .size = 4 } },
+    };
+    writeFile(dir / "mod.json", "abcd");
+    writeFile(dir / "resources" / "same.png", "abcd");
+    writeFile(dir / "resources" / "edited.png", "abcd");
+    writeFile(dir / "resources" / "truncated.png", "ab");
+    writeFile(dir / "resources" / "removed" / "old.png", "abcd");
+    // files that were never in the manifest, like leftovers from before it
+    writeFile(dir / "leftover.dll", "abcd");
+    writeFile(dir / "untracked" / "nested" / "file.txt", "abcd");
+    writeFile(dir / "modified-at", "0");
+
+    unzipManifestTest.expect(writeUnzipManifest(dir / "unzipped-entries.json", previous).isOk(), "couldn't write the manifest");
+    auto read = readUnzipManifest(dir / "unzipped-entries.json");
+    unzipManifestTest.expect(read && *read == previous, "the manifest didn't round-trip");
+
+    // what the zip has now
+    UnzipManifest current {
+        { "mod.json", { .crc32 = 1, .size = 4 } },
+        { "resources/same.png", { .crc32 = 2, .size = 4 } },
+        { "resources/edited.png", { .crc32 = 30, .size = 4 } },
+        { "resources/truncated.png", { .crc32 = 4, .size = 4 } },
+        { "resources/added.png", { .crc32 = 6, .size = 4 } },
+    };
+
+    auto changed = findChangedUnzipEntries(dir, previous, current);
+    unzipManifestTest.expect(changed.size() == 3, "wrong number of changed entries");
+    unzipManifestTest.expect(changed.contains("resources/edited.png"), "an entry with a new CRC-32 wasn't changed");
+    unzipManifestTest.expect(changed.contains("resources/truncated.png"), "an entry with the wrong size on disk wasn't changed");
+    unzipManifestTest.expect(changed.contains("resources/added.png"), "a new entry wasn't changed");
+
+    auto removed = removeUntrackedUnzipFiles(dir, current, { "modified-at", "unzipped-entries.json" });
+    unzipManifestTest.expect(removed == 3, "wrong number of untracked files removed");
+    unzipManifestTest.expect(!std::filesystem::exists(dir / "resources" / "removed"), "a removed entry or its directory was kept");
+    unzipManifestTest.expect(!std::filesystem::exists(dir / "leftover.dll"), "an untracked file was kept");
+    unzipManifestTest.expect(!std::filesystem::exists(dir / "untracked"), "an untracked directory was kept");
+    unzipManifestTest.expect(std::filesystem::exists(dir / "resources" / "same.png"), "an unchanged entry was removed");
+    unzipManifestTest.expect(std::filesystem::exists(dir / "resources" / "edited.png"), "a changed entry was removed before extracting");
+    unzipManifestTest.expect(std::filesystem::exists(dir / "modified-at"), "the modified date was removed");
+    unzipManifestTest.expect(std::filesystem::exists(dir / "unzipped-entries.json"), "the manifest was removed");
+
+    // an unreadable manifest means unzipping everything again
+    writeFile(dir / "unzipped-entries.json", R"({"mod.json": 1})");
+    unzipManifestTest.expect(!readUnzipManifest(dir / "unzipped-entries.json"), "read a manifest in the wrong format");
+
+    std::filesystem::remove_all(dir, ec);
+}
+
+#endif
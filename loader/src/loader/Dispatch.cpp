@@ -1,8 +1,23 @@
 #include <Geode/loader/Dispatch.hpp>
+#include <mutex>
 
 using namespace geode::prelude;
 
-std::unordered_map<std::string, EventListenerPool*>& geode::dispatchPools() {
+static std::unordered_map<std::string, EventListenerPool*>& getPoolMap() {
     static std::unordered_map<std::string, EventListenerPool*> pools;
     return pools;
-}
\ No newline at end of file
+}
+
+std::unordered_map<std::string, EventListenerPool*>& geode::dispatchPools() {
+    return getPoolMap();
+}
+
+EventListenerPool* geode::getDispatchPool(std::string const& id) {
+    static std::mutex mutex;
+    std::unique_lock lock(mutex);
+    auto& pool = getPoolMap()[id];
+    if (!pool) {
+        pool = DefaultEventListenerPool::create();
+    }
+    return pool;
+}
@@ -1,25 +1,232 @@
 #include <Geode/loader/Event.hpp>
-#include <Geode/utils/ranges.hpp>
+#include <atomic>
 #include <mutex>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_map>
 
 using namespace geode::prelude;
 
+namespace {
+    // Registry of per-type listener pools. Pools are created the first time
+    // a listener for that event type is enabled and are never destroyed.
+    class TypedPools final {
+        struct TypedPool {
+            DefaultEventListenerPool* pool;
+            bool(*accepts)(Event*);
+        };
+        using Route = std::vector<DefaultEventListenerPool*>;
+
+        std::mutex m_mutex;
+        std::unordered_map<std::string_view, TypedPool> m_pools;
+        // Bumped whenever a new pool is registered, since the new pool may
+        // accept an event type that already has a cached route
+        std::atomic_size_t m_generation = 0;
+
+        // Which pools an event of a given dynamic type should be sent to.
+        // Every thread keeps its own cache so posting never has to take the
+        // mutex once the route is known. Keyed by the type_info's address;
+        // the same type may show up under different addresses from
+        // different binaries, which only costs an extra cache entry
+        struct RouteCache {
+            size_t generation = 0;
+            std::unordered_map<std::type_info const*, std::shared_ptr<Route const>> routes;
+        };
+
+        std::shared_ptr<Route const> buildRoute(Event* event, std::string_view name) {
+            std::unique_lock lock(m_mutex);
+            auto route = std::make_shared<Route>();
+            // the pool for the exact type goes first, followed by pools
+            // for any base classes
+            if (auto it = m_pools.find(name); it != m_pools.end()) {
+                route->push_back(it->second.pool);
+            }
+            for (auto& [poolName, typed] : m_pools) {
+                if (poolName != name && typed.accepts(event)) {
+                    route->push_back(typed.pool);
+                }
+            }
+            return route;
+        }
+
+    public:
+        static TypedPools& get() {
+            static auto inst = new TypedPools();
+            return *inst;
+        }
+
+        DefaultEventListenerPool* getPool(char const* name, bool(*accepts)(Event*), DefaultEventListenerPool*(*create)()) {
+            std::unique_lock lock(m_mutex);
+            if (auto it = m_pools.find(name); it != m_pools.end()) {
+                return it->second.pool;
+            }
+            auto pool = create();
+            m_pools.emplace(name, TypedPool { pool, accepts });
+            m_generation.fetch_add(1, std::memory_order_release);
+            return pool;
+        }
+
+        std::shared_ptr<Route const> getRoute(Event* event) {
+            thread_local RouteCache cache;
+
+            // a route built while a pool is being registered may or may not
+            // include it, but the bumped generation makes sure it gets
+            // rebuilt on the next post
+            auto generation = m_generation.load(std::memory_order_acquire);
+            if (cache.generation != generation) {
+                cache.routes.clear();
+                cache.generation = generation;
+            }
+            auto type = &typeid(*event);
+            if (auto it = cache.routes.find(type); it != cache.routes.end()) {
+                return it->second;
+            }
+            auto route = this->buildRoute(event, type->name());
+            cache.routes.emplace(type, route);
+            return route;
+        }
+    };
+}
+
+struct DefaultEventListenerPool::Data::Entry {
+    // nulled out on removal so that handle() calls still iterating over
+    // a snapshot containing this entry skip it
+    std::atomic<EventListenerProtocol*> listener;
+};
+
+struct DefaultEventListenerPool::Data::Snapshot {
+    // entries are stored oldest first and iterated backwards, so that new
+    // listeners get priority and can be appended without touching the
+    // slots readers are currently looking at
+    std::unique_ptr<Entry*[]> entries;
+    size_t capacity;
+    std::atomic_size_t size = 0;
+
+    Snapshot(size_t capacity) : entries(new Entry*[capacity]), capacity(capacity) {}
+};
+
+DefaultEventListenerPool::Data::~Data() {
+    if (auto snapshot = m_snapshot.load()) {
+        for (size_t i = 0; i < snapshot->size; i++) {
+            delete snapshot->entries[i];
+        }
+        delete snapshot;
+    }
+    for (auto [_, snapshot] : m_retiredSnapshots) {
+        delete snapshot;
+    }
+    for (auto [_, entry] : m_retiredEntries) {
+        delete entry;
+    }
+}
+
+size_t DefaultEventListenerPool::Data::enter() {
+    while (true) {
+        auto epoch = m_epoch.load();
+        m_readers[epoch % 2] += 1;
+        // if the epoch advanced in between, the reader count we bumped
+        // may already have been checked, so try again
+        if (m_epoch.load() == epoch) {
+            return epoch;
+        }
+        m_readers[epoch % 2] -= 1;
+    }
+}
+
+void DefaultEventListenerPool::Data::leave(size_t epoch) {
+    if (--m_readers[epoch % 2] == 0 && m_hasRetired) {
+        std::unique_lock lock(m_mutex);
+        this->reclaim();
+    }
+}
+
+// Both of these expect m_mutex to be held
+
+void DefaultEventListenerPool::Data::reclaim() {
+    // the counter for the next epoch is the one readers of the previous
+    // epoch used; once that's empty, new readers can be moved to the next
+    // epoch. while events keep being posted the current epoch's readers
+    // will rarely all be gone at once, but the previous ones always leave
+    // eventually, so this still makes progress
+    for (size_t i = 0; i < 2; i++) {
+        auto epoch = m_epoch.load();
+        if (m_readers[(epoch + 1) % 2] != 0) {
+            break;
+        }
+        m_epoch = epoch + 1;
+    }
+    auto epoch = m_epoch.load();
+    std::erase_if(m_retiredSnapshots, [&](auto const& retired) {
+        if (retired.first + 2 > epoch) return false;
+        delete retired.second;
+        return true;
+    });
+    std::erase_if(m_retiredEntries, [&](auto const& retired) {
+        if (retired.first + 2 > epoch) return false;
+        delete retired.second;
+        return true;
+    });
+    m_hasRetired = !m_retiredSnapshots.empty() || !m_retiredEntries.empty();
+}
+
+// Publish a new snapshot with the removed entries dropped and optionally
+// a new entry appended
+void DefaultEventListenerPool::Data::rebuild(Entry* append) {
+    auto old = m_snapshot.load();
+    auto oldSize = old ? old->size.load() : 0;
+    auto live = oldSize - m_dead + (append ? 1 : 0);
+
+    auto snapshot = new Snapshot(std::max<size_t>(live * 2, 8));
+    auto epoch = m_epoch.load();
+    size_t size = 0;
+    for (size_t i = 0; i < oldSize; i++) {
+        auto entry = old->entries[i];
+        if (entry->listener) {
+            snapshot->entries[size++] = entry;
+        }
+        else {
+            m_retiredEntries.emplace_back(epoch, entry);
+        }
+    }
+    if (append) {
+        snapshot->entries[size++] = append;
+    }
+    snapshot->size = size;
+    m_dead = 0;
+
+    m_snapshot = snapshot;
+    if (old) {
+        m_retiredSnapshots.emplace_back(epoch, old);
+        m_hasRetired = true;
+    }
+    this->reclaim();
+}
+
 DefaultEventListenerPool::DefaultEventListenerPool() : m_data(new Data) {}
 
+DefaultEventListenerPool::~DefaultEventListenerPool() = default;
+
 bool DefaultEventListenerPool::add(EventListenerProtocol* listener) {
     if (!m_data) m_data = std::make_unique<Data>();
 
     std::unique_lock lock(m_data->m_mutex);
-    if (ranges::contains(m_data->m_listeners, listener) || ranges::contains(m_data->m_toAdd, listener)) {
+    if (m_data->m_entries.contains(listener)) {
         return false;
     }
+    auto entry = new Data::Entry { listener };
+    m_data->m_entries.emplace(listener, entry);
 
-    if (m_data->m_locked) {
-        m_data->m_toAdd.push_back(listener);
+    // if there's room left in the current snapshot, the new entry can be
+    // appended in-place; ongoing handle() calls captured the old size and
+    // won't see it
+    auto snapshot = m_data->m_snapshot.load();
+    if (snapshot && snapshot->size < snapshot->capacity) {
+        auto size = snapshot->size.load();
+        snapshot->entries[size] = entry;
+        snapshot->size.store(size + 1, std::memory_order_release);
     }
     else {
-        // insert listeners at the start so new listeners get priority
-        m_data->m_listeners.push_front(listener);
+        m_data->rebuild(entry);
     }
     return true;
 }
@@ -28,44 +235,38 @@ void DefaultEventListenerPool::remove(EventListenerProtocol* listener) {
     if (!m_data) m_data = std::make_unique<Data>();
 
     std::unique_lock lock(m_data->m_mutex);
-    if (m_data->m_locked) {
-        for (size_t i = 0 ; i < m_data->m_listeners.size(); i++) {
-            if (m_data->m_listeners[i] == listener) {
-                m_data->m_listeners[i] = nullptr;
-            }
-        }
+    auto it = m_data->m_entries.find(listener);
+    if (it == m_data->m_entries.end()) {
+        return;
     }
-    else {
-        ranges::remove(m_data->m_listeners, listener);
+    it->second->listener = nullptr;
+    m_data->m_entries.erase(it);
+    m_data->m_dead += 1;
+
+    // compact once at least half of the snapshot is removed entries
+    if (m_data->m_dead * 2 >= m_data->m_snapshot.load()->size) {
+        m_data->rebuild(nullptr);
     }
-    ranges::remove(m_data->m_toAdd, listener);
 }
 
 ListenerResult DefaultEventListenerPool::handle(Event* event) {
     if (!m_data) m_data = std::make_unique<Data>();
 
     auto res = ListenerResult::Propagate;
-    m_data->m_locked += 1;
-    std::unique_lock lock(m_data->m_mutex);
-    for (auto h : m_data->m_listeners) {
-        lock.unlock();
-        if (h && h->handle(event) == ListenerResult::Stop) {
-            res = ListenerResult::Stop;
-            lock.lock();
-            break;
-        }
-        lock.lock();
-    }
-    m_data->m_locked -= 1;
-    // only mutate listeners once nothing is iterating
-    // (if there are recursive handle calls)
-    if (m_data->m_locked == 0) {
-        ranges::remove(m_data->m_listeners, nullptr);
-        for (auto listener : m_data->m_toAdd) {
-            m_data->m_listeners.push_front(listener);
+    // registering as a reader before loading the snapshot guarantees
+    // writers won't free it until we're done
+    auto epoch = m_data->enter();
+    if (auto snapshot = m_data->m_snapshot.load()) {
+        for (auto i = snapshot->size.load(std::memory_order_acquire); i > 0; i--) {
+            auto h = snapshot->entries[i - 1]->listener.load();
+            if (h && h->handle(event) == ListenerResult::Stop) {
+                res = ListenerResult::Stop;
+                break;
+            }
         }
-        m_data->m_toAdd.clear();
     }
+    // the last reader of an epoch frees whatever has become unreachable
+    m_data->leave(epoch);
     return res;
 }
 
@@ -78,6 +279,10 @@ DefaultEventListenerPool* DefaultEventListenerPool::get() {
     return inst;
 }
 
+DefaultEventListenerPool* DefaultEventListenerPool::getForType(char const* name, bool(*accepts)(Event*)) {
+    return TypedPools::get().getPool(name, accepts, &DefaultEventListenerPool::create);
+}
+
 EventListenerPool* EventListenerProtocol::getPool() const {
     return DefaultEventListenerPool::get();
 }
@@ -113,5 +318,17 @@ EventListenerPool* Event::getPool() const {
 
 ListenerResult Event::postFromMod(Mod* m) {
     if (m) this->sender = m;
-    return this->getPool()->handle(this);
+    auto pool = this->getPool();
+    if (pool != DefaultEventListenerPool::get()) {
+        return pool->handle(this);
+    }
+    // events that use the default pool are also sent to the pools of
+    // listeners that registered for this event type specifically
+    auto route = TypedPools::get().getRoute(this);
+    for (auto typed : *route) {
+        if (typed->handle(this) == ListenerResult::Stop) {
+            return ListenerResult::Stop;
+        }
+    }
+    return pool->handle(this);
 }
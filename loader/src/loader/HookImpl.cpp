@@ -44,15 +44,24 @@ std::shared_ptr<Hook> Hook::Impl::create(
     });
 }
 
+bool Hook::Impl::isPlaceholder() const {
+    // During a transition between updates when it's important to get a
+    // non-functional version that compiles, address 0x9999999 is used to mark
+    // functions not yet RE'd but that would prevent compilation
+    return (uintptr_t)m_address == (geode::base::get() + 0x9999999);
+}
+
+void Hook::Impl::enableWithHandler(tulip::hook::HandlerHandle handler) {
+    m_handle = tulip::hook::createHook(handler, m_detour, m_hookMetadata);
+    m_enabled = true;
+}
+
 Result<> Hook::Impl::enable() {
     if (m_enabled) {
         return Ok();
     }
 
-    // During a transition between updates when it's important to get a
-    // non-functional version that compiles, address 0x9999999 is used to mark
-    // functions not yet RE'd but that would prevent compilation
-    if ((uintptr_t)m_address == (geode::base::get() + 0x9999999)) {
+    if (this->isPlaceholder()) {
         if (m_owner) {
             log::warn(
                 "Hook {} for {} uses placeholder address, refusing to hook",
@@ -66,8 +75,7 @@ Result<> Hook::Impl::enable() {
     }
 
     GEODE_UNWRAP_INTO(auto handler, LoaderImpl::get()->getOrCreateHandler(m_address, m_handlerMetadata));
-    m_handle = tulip::hook::createHook(handler, m_detour, m_hookMetadata);
-    m_enabled = true;
+    this->enableWithHandler(handler);
 
     if (m_owner) {
         log::debug("Enabled {} hook at {} for {}", m_displayName, m_address, m_owner->getID());
@@ -150,3 +158,17 @@ Result<> Hook::Impl::updateHookMetadata() {
     tulip::hook::updateHookMetadata(handler, m_handle, m_hookMetadata);
     return Ok();
 }
+
+void HookTransaction::add(Hook* hook, Mod* mod) {
+    m_hooks.emplace_back(hook, mod);
+}
+
+bool HookTransaction::empty() const {
+    return m_hooks.empty();
+}
+
+bool HookTransaction::commit() {
+    auto hooks = std::move(m_hooks);
+    m_hooks.clear();
+    return LoaderImpl::get()->enableHooks(std::move(hooks));
+}
@@ -49,6 +49,10 @@ public:
 
     Result<> enable();
     Result<> disable();
+    // placeholder addresses mark functions not yet RE'd, and are never hooked
+    bool isPlaceholder() const;
+    // attaches the hook to an already acquired handler
+    void enableWithHandler(tulip::hook::HandlerHandle handler);
     Result<> toggle();
     Result<> toggle(bool enable);
 
@@ -65,3 +69,25 @@ public:
     friend class Hook;
     friend class Mod;
 };
+
+/**
+ * Enables a group of hooks together. Hooks are grouped by target address, so
+ * each handler is looked up or created (which is what patches the target)
+ * once per address, and targets get patched in address order rather than in
+ * whatever order the hooks were claimed in
+ */
+class HookTransaction final {
+private:
+    std::vector<std::pair<Hook*, Mod*>> m_hooks;
+
+public:
+    void add(Hook* hook, Mod* mod);
+    bool empty() const;
+
+    /**
+     * Enable all of the added hooks, logging errors to the mod owning the
+     * hook. The time spent is added to each mod's startup timings
+     * @returns False if any of the hooks failed to enable
+     */
+    bool commit();
+};
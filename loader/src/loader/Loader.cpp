@@ -1,6 +1,7 @@
 #include <utility>
 
 #include "LoaderImpl.hpp"
+#include "SaveWriter.hpp"
 
 using namespace geode::prelude;
 
@@ -18,7 +19,9 @@ bool Loader::isForwardCompatMode() {
 }
 
 void Loader::saveData() {
-    return m_impl->saveData();
+    m_impl->saveData();
+    // This is expected to be synchronous
+    SaveWriter::get()->flush();
 }
 
 void Loader::loadData() {
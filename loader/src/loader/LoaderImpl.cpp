@@ -1,8 +1,11 @@
 #include "LoaderImpl.hpp"
 #include <cocos2d.h>
 
+#include "HookImpl.hpp"
 #include "ModImpl.hpp"
 #include "ModMetadataImpl.hpp"
+#include "ModMetadataCache.hpp"
+#include "UnzipManifest.hpp"
 #include "LogImpl.hpp"
 #include "console.hpp"
 
@@ -291,53 +294,86 @@ void Loader::Impl::addProblem(LoadProblem const& problem) {
 // Dependencies and refreshing
 
 void Loader::Impl::queueMods(std::vector<ModMetadata>& modQueue) {
+    struct Package {
+        std::filesystem::path path;
+        std::optional<Result<ModMetadata>> metadata;
+        std::chrono::nanoseconds duration{};
+    };
+    std::vector<Package> packages;
     for (auto const& dir : m_modSearchDirectories) {
         log::debug("Searching {}", dir);
-        log::NestScope nest;
         for (auto const& entry : std::filesystem::directory_iterator(dir)) {
             if (!std::filesystem::is_regular_file(entry) ||
                 entry.path().extension() != GEODE_MOD_EXTENSION)
                 continue;
+            packages.push_back({ .path = entry.path() });
+        }
+    }
 
-            log::debug("Found {}", entry.path().filename());
-            log::NestScope nest;
-
-            auto res = ModMetadata::createFromGeodeFile(entry.path());
-            if (!res) {
-                log::error("Failed to queue: {}", res.unwrapErr());
+    // Reading metadata is mostly waiting on storage, so read all the
+    // packages at once and only queue them in order afterwards
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        size_t remaining = packages.size();
+        for (auto& package : packages) {
+            utils::thread::Executor::getDefault()->submit([&] {
+                auto begin = std::chrono::steady_clock::now();
+                auto res = ModMetadataCache::get()->load(package.path);
+                package.duration = std::chrono::steady_clock::now() - begin;
+                package.metadata.emplace(std::move(res));
+
+                std::unique_lock lock(mutex);
+                if (--remaining == 0) {
+                    cv.notify_one();
+                }
+            });
+        }
+        std::unique_lock lock(mutex);
+        cv.wait(lock, [&] { return remaining == 0; });
+    }
 
-                auto modMetadata = ModMetadataImpl::createInvalidMetadata(
-                    entry.path().filename().string(),
-                    res.unwrapErr(),
-                    LoadProblem::Type::InvalidFile
-                );
-                modQueue.push_back(modMetadata);
-                continue;
-            }
-            auto modMetadata = res.unwrap();
+    for (auto& package : packages) {
+        log::debug("Found {}", package.path.filename());
+        log::NestScope nest;
 
-            log::debug("id: {}", modMetadata.getID());
-            log::debug("version: {}", modMetadata.getVersion());
-            log::debug("early: {}", modMetadata.needsEarlyLoad() ? "yes" : "no");
+        auto& res = *package.metadata;
+        if (!res) {
+            log::error("Failed to queue: {}", res.unwrapErr());
 
-            if (std::find_if(modQueue.begin(), modQueue.end(), [&](auto& item) {
-                    return modMetadata.getID() == item.getID();
-                }) != modQueue.end()) {
-                log::error("Failed to queue: a mod with the same ID is already queued");
+            auto modMetadata = ModMetadataImpl::createInvalidMetadata(
+                package.path.filename().string(),
+                res.unwrapErr(),
+                LoadProblem::Type::InvalidFile
+            );
+            modQueue.push_back(modMetadata);
+            continue;
+        }
+        auto modMetadata = res.unwrap();
 
-                auto modMetadata = ModMetadataImpl::createInvalidMetadata(
-                    entry.path().filename().string(),
-                    "A mod with the same ID is already present.",
-                    LoadProblem::Type::Duplicate
-                );
-                modQueue.push_back(modMetadata);
+        log::debug("id: {}", modMetadata.getID());
+        log::debug("version: {}", modMetadata.getVersion());
+        log::debug("early: {}", modMetadata.needsEarlyLoad() ? "yes" : "no");
 
-                continue;
-            }
+        if (std::find_if(modQueue.begin(), modQueue.end(), [&](auto& item) {
+                return modMetadata.getID() == item.getID();
+            }) != modQueue.end()) {
+            log::error("Failed to queue: a mod with the same ID is already queued");
 
+            auto modMetadata = ModMetadataImpl::createInvalidMetadata(
+                package.path.filename().string(),
+                "A mod with the same ID is already present.",
+                LoadProblem::Type::Duplicate
+            );
             modQueue.push_back(modMetadata);
+
+            continue;
         }
+
+        m_startupTimings[modMetadata.getID()].metadata = package.duration;
+        modQueue.push_back(modMetadata);
     }
+    ModMetadataCache::get()->save();
 }
 
 void Loader::Impl::populateModList(std::vector<ModMetadata>& modQueue) {
@@ -457,16 +493,12 @@ void Loader::Impl::loadModGraph(Mod* node, bool early) {
     m_refreshedModCount += 1;
     m_lateRefreshedModCount += early ? 0 : 1;
 
-    auto unzipFunction = [this, node]() {
-        log::debug("Unzipping .geode file");
-        auto res = this->unzipGeodeFile(node->getMetadataRef());
-        return res;
-    };
-
     auto loadFunction = [this, node, early]() {
         if (node->shouldLoad()) {
             log::debug("Loading binary");
+            auto begin = std::chrono::steady_clock::now();
             auto res = node->m_impl->loadBinary();
+            m_startupTimings[node->getID()].load = std::chrono::steady_clock::now() - begin;
             if (!res) {
                 this->addProblem({
                     LoadProblem::Type::LoadFailed,
@@ -482,8 +514,7 @@ void Loader::Impl::loadModGraph(Mod* node, bool early) {
         m_refreshingModCount -= 1;
     };
 
-    if (early) {
-        auto res = unzipFunction();
+    auto unzipped = [this, node, loadFunction](Result<> const& res) {
         if (!res) {
             this->addProblem({
                 LoadProblem::Type::UnzipFailed,
@@ -495,32 +526,155 @@ void Loader::Impl::loadModGraph(Mod* node, bool early) {
             return;
         }
         loadFunction();
+    };
+
+    // Usually already started (or even finished) by prefetchUnzips
+    auto job = this->startUnzip(node);
+    auto waitBegin = std::chrono::steady_clock::now();
+
+    if (early) {
+        std::unique_lock lock(job->mutex);
+        job->cv.wait(lock, [&] { return job->result.has_value(); });
+        auto res = *job->result;
+        m_startupTimings[node->getID()].unzip = job->duration;
+        m_startupTimings[node->getID()].unzipWait = std::chrono::steady_clock::now() - waitBegin;
+        lock.unlock();
+        unzipped(res);
     }
     else {
         auto nest = log::saveNest();
-        std::thread([=, this]() {
-            thread::setName("Mod Unzip");
+        auto then = [=, this](Result<> res) {
+            auto prevNest = log::saveNest();
             log::loadNest(nest);
-            auto res = unzipFunction();
-            this->queueInMainThread([=, this, res = std::move(res)]() {
-                auto prevNest = log::saveNest();
-                log::loadNest(nest);
-                if (!res) {
-                    this->addProblem({
-                        LoadProblem::Type::UnzipFailed,
-                        node,
-                        res.unwrapErr()
-                    });
-                    log::error("Failed to unzip: {}", res.unwrapErr());
-                    m_refreshingModCount -= 1;
-                    log::loadNest(prevNest);
-                    return;
-                }
-                loadFunction();
-                log::loadNest(prevNest);
+            m_startupTimings[node->getID()].unzip = job->duration;
+            m_startupTimings[node->getID()].unzipWait = std::chrono::steady_clock::now() - waitBegin;
+            unzipped(res);
+            log::loadNest(prevNest);
+        };
+        std::unique_lock lock(job->mutex);
+        if (job->result) {
+            auto res = *job->result;
+            lock.unlock();
+            then(std::move(res));
+        }
+        else {
+            job->then = std::move(then);
+        }
+    }
+}
+
+std::shared_ptr<ModUnzipJob> Loader::Impl::startUnzip(Mod* node) {
+    if (auto it = m_unzipJobs.find(node); it != m_unzipJobs.end()) {
+        return it->second;
+    }
+
+    if (!m_unzipExecutor) {
+        // Unzipping is limited by storage more than by the CPU, so more
+        // jobs than this only make the unzips fight over the disk
+        size_t maxJobs = std::clamp(std::thread::hardware_concurrency(), 1u, 4u);
+        if (auto value = this->getLaunchArgument("unzip-jobs")) {
+            if (auto jobs = numFromString<size_t>(*value); jobs && jobs.unwrap() > 0) {
+                maxJobs = jobs.unwrap();
+            }
+            else {
+                log::warn("Invalid value for unzip-jobs: {}", *value);
+            }
+        }
+        m_unzipExecutor = utils::thread::Executor::create("Mod Unzip", 0, maxJobs);
+    }
+
+    auto job = std::make_shared<ModUnzipJob>();
+    m_unzipJobs.insert({ node, job });
+
+    auto nest = log::saveNest();
+    m_unzipExecutor->submit([this, job, nest, metadata = node->getMetadataRef()] {
+        log::loadNest(nest);
+        log::debug("Unzipping {}", metadata.getPath().filename());
+        auto begin = std::chrono::steady_clock::now();
+        auto res = this->unzipGeodeFile(metadata);
+
+        std::function<void(Result<>)> then;
+        {
+            std::unique_lock lock(job->mutex);
+            job->duration = std::chrono::steady_clock::now() - begin;
+            job->result = res;
+            then = std::move(job->then);
+            job->then = nullptr;
+        }
+        job->cv.notify_all();
+        if (then) {
+            this->queueInMainThread([then = std::move(then), res = std::move(res)]() {
+                then(res);
             });
-        }).detach();
+        }
+    });
+    return job;
+}
+
+void Loader::Impl::prefetchUnzips() {
+    // Only unzip the mods that loadModGraph will actually get to unzipping.
+    // Their dependencies aren't enabled yet at this point, so instead of
+    // hasUnresolvedDependencies this has to check whether they will be
+    std::unordered_map<Mod*, bool> willLoad;
+    std::function<bool(Mod*, bool)> canUnzip = [&](Mod* mod, bool asDependency) -> bool {
+        if (mod->isEnabled()) {
+            return asDependency;
+        }
+        if (!mod->getMetadataRef().checkGameVersion() || !mod->getMetadataRef().checkGeodeVersion()) {
+            return false;
+        }
+        if (mod->hasUnresolvedIncompatibilities()) {
+            return false;
+        }
+        for (auto const& dep : mod->getMetadataRef().getDependencies()) {
+            if (dep.importance != ModMetadata::Dependency::Importance::Required) {
+                continue;
+            }
+            if (!dep.mod || !dep.version.compare(dep.mod->getVersion())) {
+                return false;
+            }
+            auto it = willLoad.find(dep.mod);
+            if (it == willLoad.end()) {
+                // marked first so that dependency cycles end up as false
+                willLoad[dep.mod] = false;
+                auto loads = dep.mod->shouldLoad() && canUnzip(dep.mod, true);
+                it = willLoad.insert_or_assign(dep.mod, loads).first;
+            }
+            if (!it->second) {
+                return false;
+            }
+        }
+        return true;
+    };
+    for (auto mod : m_modsToLoad) {
+        if (canUnzip(mod, false)) {
+            this->startUnzip(mod);
+        }
+    }
+}
+
+void Loader::Impl::logStartupTimings() {
+    if (m_startupTimings.empty()) return;
+
+    auto ms = [](std::chrono::nanoseconds time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    };
+    std::vector<std::pair<std::string, ModStartupTimings>> timings(m_startupTimings.begin(), m_startupTimings.end());
+    std::sort(timings.begin(), timings.end(), [](auto const& a, auto const& b) {
+        auto const& [_a, ta] = a;
+        auto const& [_b, tb] = b;
+        return ta.metadata + ta.unzipWait + ta.load > tb.metadata + tb.unzipWait + tb.load;
+    });
+
+    log::debug("Startup timings (metadata / unzip / waited for unzip / load binary / of which hooks):");
+    log::NestScope nest;
+    for (auto const& [id, time] : timings) {
+        log::debug(
+            "{}: {:.1f}ms / {:.1f}ms / {:.1f}ms / {:.1f}ms / {:.1f}ms",
+            id, ms(time.metadata), ms(time.unzip), ms(time.unzipWait), ms(time.load), ms(time.hooks)
+        );
     }
+    m_startupTimings.clear();
 }
 
 void Loader::Impl::findProblems() {
@@ -713,6 +867,7 @@ void Loader::Impl::refreshModGraph() {
         log::NestScope nest;
         this->orderModStack();
     }
+    this->prefetchUnzips();
 
     m_loadingState = LoadingState::EarlyMods;
     log::info("Loading early mods");
@@ -824,6 +979,8 @@ void Loader::Impl::continueRefreshModGraph() {
                 auto time = std::chrono::duration_cast<std::chrono::milliseconds>(end - m_timerBegin).count();
                 log::debug("Took {}s", static_cast<float>(time) / 1000.f);
             }
+            m_unzipJobs.clear();
+            this->logStartupTimings();
             break;
         default:
             m_loadingState = LoadingState::Done;
@@ -894,40 +1051,71 @@ Result<> Loader::Impl::unzipGeodeFile(ModMetadata metadata) {
     }
     log::debug("Hash mismatch detected, unzipping");
 
-    std::filesystem::remove_all(tempDir, ec);
-    if (ec) {
-        auto message = formatSystemError(ec.value());
-        return Err("Unable to delete temp dir: " + message);
-    }
-
-    (void)utils::file::createDirectoryAll(tempDir);
-
     GEODE_UNWRAP_INTO(auto unzip, file::Unzip::create(metadata.getPath()));
     if (!unzip.hasEntry(metadata.getBinaryName())) {
         return Err(
             fmt::format("Unable to find platform binary under the name \"{}\"", metadata.getBinaryName())
         );
     }
-    GEODE_UNWRAP(unzip.extractAllTo(tempDir));
 
-    // Delete binaries for other platforms since they're pointless
-    // The if should never fail, but you never know
-    for (auto& entry : std::filesystem::directory_iterator(tempDir)) {
-        if (entry.is_directory()) {
-            continue;
+    // The manifest lists what the last unzip extracted, so only the entries
+    // that have changed since then need to be extracted again. It's removed
+    // while unzipping, so if this doesn't finish the next launch starts over
+    auto manifestPath = tempDir / "unzipped-entries.json";
+    auto previous = readUnzipManifest(manifestPath);
+    if (previous) {
+        std::filesystem::remove(manifestPath, ec);
+    }
+    else {
+        std::filesystem::remove_all(tempDir, ec);
+        if (ec) {
+            auto message = formatSystemError(ec.value());
+            return Err("Unable to delete temp dir: " + message);
         }
+    }
 
-        const std::string filename = utils::string::pathToString(entry.path().filename());
-        if (filename == metadata.getBinaryName() || !isPlatformBinary(metadata.getID(), filename)) {
+    (void)utils::file::createDirectoryAll(tempDir);
+
+    UnzipManifest current;
+    for (auto const& name : unzip.getEntries()) {
+        auto info = unzip.getEntryInfo(name);
+        if (!info || info.unwrap().isDirectory || !isInsideDir(tempDir, tempDir / name)) {
             continue;
         }
-
-        // The binary is not for our platform, delete!
-        // We don't really care if the deletion succeeds though.
-        std::error_code ec;
-        std::filesystem::remove(entry.path(), ec);
+        // Binaries for other platforms are pointless, so don't extract them
+        const std::string filename = utils::string::pathToString(name.filename());
+        if (
+            !name.has_parent_path() && filename != metadata.getBinaryName() &&
+            isPlatformBinary(metadata.getID(), filename)
+        ) {
+            continue;
+        }
+        current[utils::string::pathToString(name)] = UnzipManifestEntry {
+            .crc32 = info.unwrap().crc32,
+            .size = info.unwrap().size,
+        };
+    }
+
+    std::unordered_set<std::string> changed;
+    if (previous) {
+        changed = findChangedUnzipEntries(tempDir, *previous, current);
+        // This also removes files that were never extracted from the zip,
+        // which remove_all used to take care of
+        auto removed = removeUntrackedUnzipFiles(
+            tempDir, current,
+            { utils::string::pathToString(datePath.filename()), utils::string::pathToString(manifestPath.filename()) }
+        );
+        log::debug("Extracting {} of {} entries, removed {} files", changed.size(), current.size(), removed);
+    }
+    else {
+        for (auto const& [name, _] : current) {
+            changed.insert(name);
+        }
     }
 
+    GEODE_UNWRAP(unzip.extractAllTo(tempDir, [&](std::filesystem::path const& name) {
+        return changed.contains(utils::string::pathToString(name));
+    }));
     // Check if there is a binary that we need to move over from the unzipped binaries dir
     if (this->isPatchless()) {
         // TODO: enable in 4.7.0
@@ -946,6 +1134,10 @@ Result<> Loader::Impl::unzipGeodeFile(ModMetadata metadata) {
         }
     }
 
+    if (auto res = writeUnzipManifest(manifestPath, current); !res) {
+        log::warn("Failed to write unzipped entries, will unzip everything next time: {}", res.unwrapErr());
+    }
+
     auto res = file::writeString(datePath, modifiedHash);
     if (!res) {
         log::warn("Failed to write modified date of geode zip, will try to unzip next launch: {}", res.unwrapErr());
@@ -976,15 +1168,84 @@ Result<> Loader::Impl::extractBinary(ModMetadata metadata) {
 
 bool Loader::Impl::loadHooks() {
     m_readyToHook = true;
-    bool hadErrors = false;
+    HookTransaction transaction;
     for (auto const& [hook, mod] : m_uninitializedHooks) {
-        auto res = hook->enable();
-        if (!res) {
-            log::logImpl(Severity::Error, mod, "{}", res.unwrapErr());
-            hadErrors = true;
-        }
+        transaction.add(hook, mod);
     }
     m_uninitializedHooks.clear();
+    return transaction.commit();
+}
+
+bool Loader::Impl::enableHooks(std::vector<std::pair<Hook*, Mod*>> hooks) {
+    // the same hook may have been added twice (which would attach it to
+    // its handler twice), and placeholders go through the regular path so
+    // they still get their warning
+    std::unordered_set<Hook*> seen;
+    std::erase_if(hooks, [&](auto const& pair) {
+        if (!seen.insert(pair.first).second) return true;
+        auto impl = pair.first->m_impl.get();
+        if (impl->m_enabled) return true;
+        if (impl->isPlaceholder()) {
+            (void)impl->enable();
+            return true;
+        }
+        return false;
+    });
+    std::stable_sort(hooks.begin(), hooks.end(), [](auto const& a, auto const& b) {
+        return a.first->m_impl->m_address < b.first->m_impl->m_address;
+    });
+
+    struct ModStats {
+        size_t count = 0;
+        std::chrono::nanoseconds time{};
+    };
+    std::unordered_map<Mod*, ModStats> stats;
+    bool hadErrors = false;
+
+    for (auto begin = hooks.begin(); begin != hooks.end();) {
+        auto address = begin->first->m_impl->m_address;
+        auto end = std::find_if(begin, hooks.end(), [&](auto const& pair) {
+            return pair.first->m_impl->m_address != address;
+        });
+        auto count = static_cast<size_t>(end - begin);
+
+        auto start = std::chrono::steady_clock::now();
+        auto handler = this->getOrCreateHandler(
+            address, begin->first->m_impl->m_handlerMetadata, count
+        );
+        if (handler) {
+            for (auto it = begin; it != end; ++it) {
+                it->first->m_impl->enableWithHandler(handler.unwrap());
+            }
+        }
+        // shared handlers are split evenly between the hooks using them
+        auto share = (std::chrono::steady_clock::now() - start) / count;
+
+        for (auto it = begin; it != end; ++it) {
+            auto& [hook, mod] = *it;
+            if (!handler) {
+                log::logImpl(
+                    Severity::Error, mod, "Failed to enable {} hook: {}",
+                    hook->getDisplayName(), handler.unwrapErr()
+                );
+                hadErrors = true;
+                continue;
+            }
+            stats[mod].count += 1;
+            stats[mod].time += share;
+        }
+        begin = end;
+    }
+
+    for (auto const& [mod, stat] : stats) {
+        auto id = mod ? mod->getID() : std::string("<unowned>");
+        m_startupTimings[id].hooks += stat.time;
+        log::debug(
+            "Enabled {} hooks for {} in {:.1f}ms", stat.count, id,
+            std::chrono::duration<double, std::milli>(stat.time).count()
+        );
+    }
+
     return !hadErrors;
 }
 
@@ -1094,16 +1355,18 @@ Result<tulip::hook::HandlerHandle> Loader::Impl::getHandler(void* address) {
     return Ok(m_handlerHandles[address].first);
 }
 
-Result<tulip::hook::HandlerHandle> Loader::Impl::getOrCreateHandler(void* address, tulip::hook::HandlerMetadata const& metadata) {
-    if (m_handlerHandles.count(address) && m_handlerHandles[address].second > 0) {
-        m_handlerHandles[address].second++;
-        return Ok(m_handlerHandles[address].first);
+Result<tulip::hook::HandlerHandle> Loader::Impl::getOrCreateHandler(
+    void* address, tulip::hook::HandlerMetadata const& metadata, size_t users
+) {
+    auto it = m_handlerHandles.find(address);
+    if (it != m_handlerHandles.end() && it->second.second > 0) {
+        it->second.second += users;
+        return Ok(it->second.first);
     }
     tulip::hook::HandlerHandle handle;
     GEODE_UNWRAP_INTO(handle, tulip::hook::createHandler(address, metadata));
 
-    m_handlerHandles[address].first = handle;
-    m_handlerHandles[address].second = 1;
+    m_handlerHandles[address] = { handle, users };
     return Ok(handle);
 }
 
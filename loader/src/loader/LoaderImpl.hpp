@@ -10,8 +10,10 @@
 #include <Geode/Result.hpp>
 #include <Geode/utils/map.hpp>
 #include <Geode/utils/ranges.hpp>
+#include <Geode/utils/Executor.hpp>
 #include "ModImpl.hpp"
 #include <crashlog.hpp>
+#include <condition_variable>
 #include <mutex>
 #include <optional>
 #include <thread>
@@ -24,6 +26,26 @@
 namespace geode {
     static constexpr std::string_view LAUNCH_ARG_PREFIX = "--geode:";
 
+    // How long each startup phase took for a single mod
+    struct ModStartupTimings {
+        std::chrono::nanoseconds metadata{};
+        std::chrono::nanoseconds unzip{};
+        // Time the main thread spent waiting for the unzip to finish
+        std::chrono::nanoseconds unzipWait{};
+        std::chrono::nanoseconds load{};
+        std::chrono::nanoseconds hooks{};
+    };
+
+    // A .geode package being unzipped in the background at startup
+    struct ModUnzipJob {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::optional<Result<>> result;
+        // Called on the main thread once the unzip is done
+        std::function<void(Result<>)> then;
+        std::chrono::nanoseconds duration{};
+    };
+
     class Loader::Impl {
     public:
         mutable std::mutex m_mutex;
@@ -61,6 +83,10 @@ namespace geode {
 
         std::chrono::time_point<std::chrono::high_resolution_clock> m_timerBegin;
 
+        std::unique_ptr<utils::thread::Executor> m_unzipExecutor;
+        std::unordered_map<Mod*, std::shared_ptr<ModUnzipJob>> m_unzipJobs;
+        std::unordered_map<std::string, ModStartupTimings> m_startupTimings;
+
         std::string getGameVersion();
         bool isForwardCompatMode();
 
@@ -74,11 +100,15 @@ namespace geode {
         std::optional<std::string> m_binaryPath;
 
         Result<tulip::hook::HandlerHandle> getHandler(void* address);
-        Result<tulip::hook::HandlerHandle> getOrCreateHandler(void* address, tulip::hook::HandlerMetadata const& metadata);
+        Result<tulip::hook::HandlerHandle> getOrCreateHandler(
+            void* address, tulip::hook::HandlerMetadata const& metadata, size_t users = 1
+        );
         Result<tulip::hook::HandlerHandle> getAndDecreaseHandler(void* address);
         Result<> removeHandlerIfNeeded(void* address);
 
         bool loadHooks();
+        // see HookTransaction
+        bool enableHooks(std::vector<std::pair<Hook*, Mod*>> hooks);
 
         Impl();
         ~Impl();
@@ -106,6 +136,9 @@ namespace geode {
         void buildModGraph();
         void orderModStack();
         void loadModGraph(Mod* node, bool early);
+        void prefetchUnzips();
+        std::shared_ptr<ModUnzipJob> startUnzip(Mod* node);
+        void logStartupTimings();
         void findProblems();
         void refreshModGraph();
         void continueRefreshModGraph();
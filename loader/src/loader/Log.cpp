@@ -10,6 +10,7 @@
 #include <Geode/utils/general.hpp>
 #include <fmt/chrono.h>
 #include <fmt/format.h>
+#include <atomic>
 #include <iomanip>
 #include <memory>
 #include <ostream>
@@ -21,7 +22,7 @@ using namespace cocos2d;
 
 // Parse overloads
 
-static bool g_logMillis = false;
+static std::atomic_bool g_logMillis = false;
 
 std::string geode::format_as(Mod* mod) {
     if (mod) {
@@ -227,9 +228,86 @@ Severity Log::getSeverity() const {
 
 // Logger
 
+// How many logs can be waiting for the writer before pushing blocks
+static constexpr size_t LOG_QUEUE_CAPACITY = 8192;
+// How many logs are kept in memory for showing in-game
+static constexpr size_t MAX_LOGS_IN_MEMORY = 2000;
+// How often the log file is flushed if no errors or warnings are logged
+static constexpr auto LOG_FLUSH_INTERVAL = std::chrono::seconds(1);
+
+LogRingBuffer::LogRingBuffer(size_t capacity)
+  : m_slots(std::make_unique<Slot[]>(capacity)), m_mask(capacity - 1)
+{
+    for (size_t i = 0; i < capacity; i++) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool LogRingBuffer::tryPush(Log&& log) {
+    auto pos = m_pushPos.load(std::memory_order_relaxed);
+    while (true) {
+        auto& slot = m_slots[pos & m_mask];
+        auto seq = slot.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            // the slot is free; claim it
+            if (m_pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.log.emplace(std::move(log));
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0) {
+            // the writer hasn't gotten to this slot yet
+            return false;
+        }
+        else {
+            pos = m_pushPos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+std::optional<Log> LogRingBuffer::tryPop() {
+    auto pos = m_popPos.load(std::memory_order_relaxed);
+    auto& slot = m_slots[pos & m_mask];
+    auto seq = slot.sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+        return std::nullopt;
+    }
+    m_popPos.store(pos + 1, std::memory_order_relaxed);
+    auto log = std::move(slot.log);
+    slot.log.reset();
+    // hand the slot back to the producers for the next lap around the buffer
+    slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return log;
+}
+
+bool LogRingBuffer::empty() const {
+    auto pos = m_popPos.load(std::memory_order_relaxed);
+    auto seq = m_slots[pos & m_mask].sequence.load(std::memory_order_acquire);
+    return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0;
+}
+
+Logger::Logger() : m_queue(LOG_QUEUE_CAPACITY) {}
+
 Logger* Logger::get() {
-    static Logger inst;
-    return &inst;
+    // Never destroyed, as the writer thread may still be running at exit
+    static auto inst = new Logger();
+    return inst;
+}
+
+static Severity::type parseLogLevel(std::string const& level) {
+    if (level == "debug") {
+        return Severity::Debug;
+    } else if (level == "info") {
+        return Severity::Info;
+    } else if (level == "warn") {
+        return Severity::Warning;
+    } else if (level == "error") {
+        return Severity::Error;
+    } else {
+        return Severity::Info;
+    }
 }
 
 void Logger::setup() {
@@ -242,6 +320,16 @@ void Logger::setup() {
         g_logMillis = val;
     });
 
+    // Looking the levels up for every log is way too slow, so cache them
+    m_consoleLevel = parseLogLevel(Mod::get()->getSettingValue<std::string>("console-log-level"));
+    m_fileLevel = parseLogLevel(Mod::get()->getSettingValue<std::string>("file-log-level"));
+    listenForSettingChanges("console-log-level", [this](std::string val) {
+        m_consoleLevel = parseLogLevel(val);
+    });
+    listenForSettingChanges("file-log-level", [this](std::string val) {
+        m_fileLevel = parseLogLevel(val);
+    });
+
     auto logDir = dirs::getGeodeLogDir();
 
     // on the first launch, this doesn't exist yet..
@@ -252,24 +340,32 @@ void Logger::setup() {
 
     m_logPath = logDir / log::generateLogName();
     m_logStream = std::ofstream(m_logPath);
-
-    Severity consoleLogLevel = this->getConsoleLogLevel();
-    Severity fileLogLevel = this->getFileLogLevel();
+    m_lastFlush = std::chrono::steady_clock::now();
 
     // Logs can and will probably be added before setup() is called, so we'll write them now
-    for (Log const& log : m_logs) {
-        const std::string logStr = log.toString(g_logMillis);
-        if (log.getSeverity() >= consoleLogLevel) {
-            console::log(logStr, log.getSeverity());
-        }
-        if (log.getSeverity() >= fileLogLevel) {
-            m_logStream << fmt::format("{}\n", logStr);
+    {
+        std::lock_guard pending(m_pendingMutex);
+        std::lock_guard writing(m_writeMutex);
+
+        std::string fileBuffer;
+        bool flush = false;
+        for (auto& log : m_pending) {
+            this->write(std::move(log), fileBuffer, flush);
         }
+        m_pending.clear();
+        m_logStream << fileBuffer << std::flush;
+
+        m_initialized = true;
     }
 
-    m_logStream << std::flush;
+    std::thread([this] {
+        thread::setName("Log Writer");
+        this->runWriter();
+    }).detach();
 
-    m_initialized = true;
+    std::atexit([] {
+        Logger::get()->flush();
+    });
 }
 
 void Logger::deleteOldLogs(size_t maxAgeHours) {
@@ -299,74 +395,122 @@ void Logger::deleteOldLogs(size_t maxAgeHours) {
     }
 }
 
-std::mutex& getLogMutex() {
-    static std::mutex mutex;
-    return mutex;
-}
-
 Severity Logger::getConsoleLogLevel() {
-    const std::string level = Mod::get()->getSettingValue<std::string>("console-log-level");
-    if (level == "debug") {
-        return Severity::Debug;
-    } else if (level == "info") {
-        return Severity::Info;
-    } else if (level == "warn") {
-        return Severity::Warning;
-    } else if (level == "error") {
-        return Severity::Error;
-    } else {
-        return Severity::Info;
-    }
+    return m_consoleLevel.load();
 }
 
 Severity Logger::getFileLogLevel() {
-    const std::string level = Mod::get()->getSettingValue<std::string>("file-log-level");
-    if (level == "debug") {
-        return Severity::Debug;
-    } else if (level == "info") {
-        return Severity::Info;
-    } else if (level == "warn") {
-        return Severity::Warning;
-    } else if (level == "error") {
-        return Severity::Error;
-    } else {
-        return Severity::Info;
-    }
+    return m_fileLevel.load();
 }
 
-
 void Logger::push(Severity sev, std::string&& thread, std::string&& source, int32_t nestCount,
     std::string&& content) {
-    std::lock_guard g(getLogMutex());
-
-    Log& log = m_logs.emplace_back(sev, std::move(thread), std::move(source), nestCount,
-            std::move(content));
+    Log log(sev, std::move(thread), std::move(source), nestCount, std::move(content));
 
     // If logger is not initialized, store the log anyway. When the logger is initialized the pending logs will be logged.
     if (!m_initialized) {
-        return;
+        std::lock_guard g(m_pendingMutex);
+        if (!m_initialized) {
+            m_pending.push_back(std::move(log));
+            return;
+        }
+    }
+
+    while (!m_queue.tryPush(std::move(log))) {
+        // The writer is falling behind; help it out instead of waiting
+        if (m_writeMutex.try_lock()) {
+            this->writeQueued();
+            m_writeMutex.unlock();
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    // Errors and warnings go out right away in case they are followed by a crash
+    if (m_writerSleeping || sev >= Severity::Warning) {
+        std::lock_guard g(m_wakeMutex);
+        m_wakeCV.notify_one();
     }
+}
+
+void Logger::runWriter() {
+    while (true) {
+        {
+            std::unique_lock lock(m_wakeMutex);
+            m_writerSleeping = true;
+            m_wakeCV.wait_for(lock, LOG_FLUSH_INTERVAL, [this] { return !m_queue.empty(); });
+            m_writerSleeping = false;
+        }
+        // Let a few more logs pile up so they get written in one go
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
 
-    auto const logStr = log.toString(g_logMillis);
+        std::lock_guard g(m_writeMutex);
+        this->writeQueued();
+    }
+}
 
-    if (sev >= this->getConsoleLogLevel()) {
-        console::log(logStr, log.getSeverity());
+void Logger::writeQueued() {
+    std::string fileBuffer;
+    bool flush = false;
+    while (auto log = m_queue.tryPop()) {
+        this->write(std::move(*log), fileBuffer, flush);
+    }
+    if (!fileBuffer.empty()) {
+        m_logStream << fileBuffer;
     }
-    if (sev >= this->getFileLogLevel()) {
-        m_logStream << logStr << std::endl;
+    auto now = std::chrono::steady_clock::now();
+    if (flush || now - m_lastFlush >= LOG_FLUSH_INTERVAL) {
+        m_logStream.flush();
+        m_lastFlush = now;
+    }
+}
+
+void Logger::write(Log&& log, std::string& fileBuffer, bool& flush) {
+    auto sev = log.getSeverity();
+    if (sev >= m_consoleLevel.load() || sev >= m_fileLevel.load()) {
+        auto const logStr = log.toString(g_logMillis);
+        if (sev >= m_consoleLevel.load()) {
+            console::log(logStr, sev);
+        }
+        if (sev >= m_fileLevel.load()) {
+            fileBuffer += logStr;
+            fileBuffer += '\n';
+            flush |= sev >= Severity::Warning;
+        }
+    }
+
+    std::lock_guard g(m_logsMutex);
+    m_logs.push_back(std::move(log));
+    if (m_logs.size() > MAX_LOGS_IN_MEMORY) {
+        m_logs.pop_front();
+    }
+}
+
+void Logger::flush() {
+    if (!m_initialized) {
+        return;
+    }
+    // Don't wait forever in case the writer crashed while holding the lock
+    if (!m_writeMutex.try_lock_for(std::chrono::milliseconds(200))) {
+        return;
     }
+    this->writeQueued();
+    m_logStream.flush();
+    m_writeMutex.unlock();
 }
 
 Nest::Nest(std::shared_ptr<Nest::Impl> impl) : m_impl(std::move(impl)) { }
 Nest::Impl::Impl(int32_t nestLevel, int32_t nestCountOffset) :
     m_nestLevel(nestLevel), m_nestCountOffset(nestCountOffset) { }
 
-std::vector<Log> const& Logger::list() {
-    return m_logs;
+std::vector<Log> Logger::list() {
+    std::lock_guard g(m_logsMutex);
+    return std::vector<Log>(m_logs.begin(), m_logs.end());
 }
 
 void Logger::clear() {
-    std::lock_guard g(getLogMutex());
+    std::lock_guard g(m_logsMutex);
     m_logs.clear();
 }
 
@@ -4,10 +4,17 @@
 #include <Geode/loader/Log.hpp>
 #include <Geode/loader/Mod.hpp>
 #include <Geode/loader/Types.hpp>
-#include <vector>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
-#include <chrono>
+#include <thread>
+#include <vector>
 
 namespace geode::log {
     class Log final {
@@ -20,6 +27,10 @@ namespace geode::log {
 
     public:
         ~Log();
+        Log(Log const&) = default;
+        Log(Log&&) = default;
+        Log& operator=(Log const&) = default;
+        Log& operator=(Log&&) = default;
         Log(Severity sev, std::string&& thread, std::string&& source, int32_t nestCount,
             std::string&& content);
 
@@ -30,14 +41,64 @@ namespace geode::log {
         [[nodiscard]] Severity getSeverity() const;
     };
 
+    /**
+     * Fixed-size queue that any number of threads can push logs into
+     * without locking, and one thread (the log writer) takes them out of
+     */
+    class LogRingBuffer final {
+    private:
+        struct Slot {
+            std::atomic_size_t sequence;
+            std::optional<Log> log;
+        };
+        std::unique_ptr<Slot[]> m_slots;
+        size_t m_mask;
+        alignas(64) std::atomic_size_t m_pushPos = 0;
+        alignas(64) std::atomic_size_t m_popPos = 0;
+
+    public:
+        // Capacity must be a power of two
+        explicit LogRingBuffer(size_t capacity);
+
+        // Returns false if the buffer is full
+        bool tryPush(Log&& log);
+        // Only safe to call from one thread at a time
+        std::optional<Log> tryPop();
+        bool empty() const;
+    };
+
     class Logger {
     private:
-        bool m_initialized = false;
-        std::vector<Log> m_logs;
+        std::atomic_bool m_initialized = false;
+        // Logs pushed before setup(); written out once setup() opens the file
+        std::mutex m_pendingMutex;
+        std::vector<Log> m_pending;
+
+        LogRingBuffer m_queue;
+        // Held by whoever is currently writing logs out
+        std::timed_mutex m_writeMutex;
+        std::mutex m_wakeMutex;
+        std::condition_variable m_wakeCV;
+        std::atomic_bool m_writerSleeping = false;
+        std::chrono::steady_clock::time_point m_lastFlush;
+
+        // The most recent logs, for showing in-game
+        mutable std::mutex m_logsMutex;
+        std::deque<Log> m_logs;
+
         std::ofstream m_logStream;
         std::filesystem::path m_logPath;
 
-        Logger() = default;
+        std::atomic<Severity::type> m_consoleLevel = Severity::Info;
+        std::atomic<Severity::type> m_fileLevel = Severity::Info;
+
+        Logger();
+
+        void runWriter();
+        // Must be called with m_writeMutex locked
+        void writeQueued();
+        void write(Log&& log, std::string& fileBuffer, bool& flush);
+
     public:
         static Logger* get();
 
@@ -46,7 +107,13 @@ namespace geode::log {
         void push(Severity sev, std::string&& thread, std::string&& source, int32_t nestCount,
             std::string&& content);
 
-        std::vector<Log> const& list();
+        /**
+         * Write out every log pushed so far and flush the log file. Gives up
+         * if the writer is stuck, which can happen when called while crashing
+         */
+        void flush();
+
+        std::vector<Log> list();
         Severity getConsoleLogLevel();
         Severity getFileLogLevel();
         void clear();
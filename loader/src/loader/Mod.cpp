@@ -1,10 +1,12 @@
 #include "ModImpl.hpp"
+#include "SaveWriter.hpp"
 
 #include <Geode/loader/Dirs.hpp>
 #include <Geode/loader/Mod.hpp>
 #include <loader/ModMetadataImpl.hpp>
 #include <optional>
 #include <string_view>
+#include <utility>
 #include <server/Server.hpp>
 
 using namespace geode::prelude;
@@ -45,6 +47,10 @@ matjson::Value& Mod::getSaveContainer() {
     return m_impl->getSaveContainer();
 }
 
+matjson::Value const& Mod::getSaveContainer() const {
+    return std::as_const(*m_impl).getSaveContainer();
+}
+
 matjson::Value& Mod::getSavedSettingsData() {
     return m_impl->m_settings->getSaveData();
 }
@@ -132,7 +138,10 @@ Mod::CheckUpdatesTask Mod::checkUpdates() const {
 }
 
 Result<> Mod::saveData() {
-    return m_impl->saveData();
+    GEODE_UNWRAP(m_impl->saveData());
+    // This is expected to be synchronous
+    SaveWriter::get()->flush();
+    return Ok();
 }
 
 Result<> Mod::loadData() {
@@ -272,7 +281,7 @@ void Mod::setLogLevel(Severity level) {
 }
 
 bool Mod::hasSavedValue(std::string_view key) {
-    return this->getSaveContainer().contains(key);
+    return std::as_const(*this).getSaveContainer().contains(key);
 }
 
 bool Mod::hasLoadProblems() const {
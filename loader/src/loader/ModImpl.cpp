@@ -3,6 +3,7 @@
 #include "ModMetadataImpl.hpp"
 #include "HookImpl.hpp"
 #include "PatchImpl.hpp"
+#include "SaveWriter.hpp"
 #include "about.hpp"
 #include "console.hpp"
 
@@ -160,6 +161,10 @@ matjson::Value& Mod::Impl::getSaveContainer() {
     return m_saved;
 }
 
+matjson::Value const& Mod::Impl::getSaveContainer() const {
+    return m_saved;
+}
+
 bool Mod::Impl::isEnabled() const {
     return m_enabled || this->isInternal();
 }
@@ -199,11 +204,15 @@ Result<> Mod::Impl::loadData() {
     // Check if settings exist
     auto settingPath = m_saveDirPath / "settings.json";
     if (std::filesystem::exists(settingPath)) {
-        GEODE_UNWRAP_INTO(auto json, utils::file::readJson(settingPath));
+        GEODE_UNWRAP_INTO(auto data, utils::file::readString(settingPath));
+        GEODE_UNWRAP_INTO(auto json, matjson::parse(data).mapErr([](auto&& err) {
+            return fmt::format("Unable to parse settings: {}", err);
+        }));
         auto load = m_settings->load(json);
         if (!load) {
             log::warn("Unable to load settings: {}", load.unwrapErr());
         }
+        m_lastSavedSettingsHash = calculateFNV1a(data);
     }
 
     // Saved values
@@ -217,6 +226,7 @@ Result<> Mod::Impl::loadData() {
             log::warn("saved.json was somehow not an object, forcing it to one");
             m_saved = matjson::Value::object();
         }
+        m_lastSavedHash = calculateFNV1a(data);
     }
 
     return Ok();
@@ -232,19 +242,22 @@ Result<> Mod::Impl::saveData() {
         return Ok();
     }
 
-    // ModSettingsManager keeps track of the whole savedata
-    matjson::Value json = m_settings->save();
-
     // saveData is expected to be synchronous, and always called from GD thread
     ModStateEvent(m_self, ModEventType::DataSaved).post();
 
-    auto res = utils::file::writeStringSafe(m_saveDirPath / "settings.json", json.dump());
-    if (!res) {
-        log::error("Unable to save settings: {}", res.unwrapErr());
+    // Only the files whose contents changed since the last save get
+    // written, which happens on the save writer. Keeping a hash rather than
+    // a copy of the last contents doesn't double the memory of large saves
+    // ModSettingsManager keeps track of the whole savedata
+    auto settings = m_settings->save().dump();
+    if (auto hash = calculateFNV1a(settings); hash != m_lastSavedSettingsHash) {
+        m_lastSavedSettingsHash = hash;
+        SaveWriter::get()->queue(m_saveDirPath / "settings.json", std::move(settings), this->getID());
     }
-    auto res2 = utils::file::writeStringSafe(m_saveDirPath / "saved.json", m_saved.dump());
-    if (!res2) {
-        log::error("Unable to save values: {}", res2.unwrapErr());
+    auto saved = m_saved.dump();
+    if (auto hash = calculateFNV1a(saved); hash != m_lastSavedHash) {
+        m_lastSavedHash = hash;
+        SaveWriter::get()->queue(m_saveDirPath / "saved.json", std::move(saved), this->getID());
     }
 
     return Ok();
@@ -328,7 +341,21 @@ Result<> Mod::Impl::loadBinary() {
 
     m_enabled = true;
     m_isCurrentlyLoading = true;
+    m_deferHooks = true;
     auto res = this->loadPlatformBinary();
+    m_deferHooks = false;
+
+    // the hooks were enabled immediately before batching, so keep doing
+    // that even if loading failed
+    if (!m_deferredHooks.empty()) {
+        HookTransaction transaction;
+        for (auto hook : m_deferredHooks) {
+            transaction.add(hook, m_self);
+        }
+        m_deferredHooks.clear();
+        (void)transaction.commit();
+    }
+
     if (!res) {
         m_isCurrentlyLoading = false;
         m_enabled = false;
@@ -496,6 +523,12 @@ Result<Hook*> Mod::Impl::claimHook(std::shared_ptr<Hook> hook) {
         return Ok(ptr);
     }
 
+    // hooks from static initializers get enabled in one go after loading
+    if (m_deferHooks) {
+        m_deferredHooks.push_back(ptr);
+        return Ok(ptr);
+    }
+
     auto res2 = ptr->enable();
     if (!res2) {
         return Err("Cannot enable hook: {}", res2.unwrapErr());
@@ -513,6 +546,7 @@ Result<> Mod::Impl::disownHook(Hook* hook) {
     if (!res1) {
         return Err("Cannot disown hook: {}", res1.unwrapErr());
     }
+    std::erase(m_deferredHooks, hook);
 
     auto foundIt = std::find_if(m_hooks.begin(), m_hooks.end(), [&](auto& a) {
         return a.get() == hook;
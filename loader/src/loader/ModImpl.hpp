@@ -22,6 +22,12 @@ namespace geode {
          * Hooks owned by this mod
          */
         std::vector<std::shared_ptr<Hook>> m_hooks;
+        /**
+         * Hooks claimed while the binary is loading, which are enabled
+         * together once it has finished
+         */
+        std::vector<Hook*> m_deferredHooks;
+        bool m_deferHooks = false;
         /**
          * Patches owned by this mod
          */
@@ -48,6 +54,14 @@ namespace geode {
          * Saved values
          */
         matjson::Value m_saved = matjson::Value();
+        /**
+         * Hashes of saved.json and settings.json as they were last read from
+         * or queued for writing to disk. The files only get written again if
+         * the current contents hash different, since they can be modified
+         * through references and by setting types that are never told about
+         */
+        uint64_t m_lastSavedHash = 0;
+        uint64_t m_lastSavedSettingsHash = 0;
         /**
          * Setting values. This is behind unique_ptr for interior mutability
          */
@@ -104,6 +118,7 @@ namespace geode {
         bool isEphemeral() const;
 
         matjson::Value& getSaveContainer();
+        matjson::Value const& getSaveContainer() const;
 
 #if defined(GEODE_EXPOSE_SECRET_INTERNALS_IN_HEADERS_DO_NOT_DEFINE_PLEASE)
         void setMetadata(ModMetadata const& metadata);
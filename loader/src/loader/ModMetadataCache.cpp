@@ -0,0 +1,184 @@
+#include "ModMetadataCache.hpp"
+#include "ModMetadataImpl.hpp"
+
+#include <Geode/loader/Dirs.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/string.hpp>
+#include <about.hpp>
+#include <mutex>
+#include <unordered_map>
+
+using namespace geode::prelude;
+
+// Bump whenever the format of the cache changes
+static constexpr int CACHE_VERSION = 1;
+
+using PackageStamp = ModMetadataCache::PackageStamp;
+
+namespace {
+    struct CachedMetadata {
+        PackageStamp stamp;
+        ModJson json;
+        bool hasSpecialFiles;
+    };
+}
+
+class ModMetadataCache::Impl final {
+public:
+    std::mutex m_mutex;
+    bool m_loaded = false;
+    bool m_dirty = false;
+    std::unordered_map<std::string, CachedMetadata> m_entries;
+    // Packages that were looked up since the last save; the rest are stale
+    std::unordered_map<std::string, CachedMetadata> m_used;
+
+    // Anything cached by a different build of the loader may have been
+    // parsed differently
+    static std::string getLoaderStamp() {
+        return fmt::format("{}-{}", about::getLoaderVersionStr(), about::getLoaderCommitHash());
+    }
+
+    static std::filesystem::path getPath() {
+        return dirs::getModRuntimeDir() / "metadata-cache.json";
+    }
+
+    // Must be called with m_mutex locked
+    void loadFromDisk() {
+        if (m_loaded) return;
+        m_loaded = true;
+
+        auto read = file::readString(getPath());
+        if (!read) return;
+        auto parsed = matjson::parse(read.unwrap());
+        if (!parsed) {
+            log::warn("Mod metadata cache is corrupted, ignoring it");
+            return;
+        }
+        auto json = parsed.unwrap();
+        if (
+            json["version"].asInt().unwrapOr(0) != CACHE_VERSION ||
+            json["loader"].asString().unwrapOr("") != getLoaderStamp()
+        ) {
+            return;
+        }
+        for (auto const& [path, entry] : json["mods"]) {
+            auto size = entry["size"].asInt();
+            auto modified = entry["modified"].asInt();
+            if (!size || !modified || !entry.contains("mod.json")) {
+                continue;
+            }
+            m_entries.insert({ path, CachedMetadata {
+                .stamp = PackageStamp {
+                    .size = static_cast<uintmax_t>(size.unwrap()),
+                    .modified = static_cast<int64_t>(modified.unwrap()),
+                },
+                .json = entry["mod.json"],
+                .hasSpecialFiles = entry["special-files"].asBool().unwrapOr(true),
+            }});
+        }
+    }
+};
+
+ModMetadataCache* ModMetadataCache::get() {
+    static auto inst = new ModMetadataCache();
+    return inst;
+}
+
+ModMetadataCache::ModMetadataCache() : m_impl(std::make_unique<Impl>()) {}
+ModMetadataCache::~ModMetadataCache() = default;
+
+Result<PackageStamp> ModMetadataCache::stamp(std::filesystem::path const& path) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return Err("Unable to get size of {}: {}", path, ec.message());
+    }
+    auto modified = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return Err("Unable to get last modified time of {}: {}", path, ec.message());
+    }
+    return Ok(PackageStamp {
+        .size = size,
+        .modified = std::chrono::duration_cast<std::chrono::milliseconds>(modified.time_since_epoch()).count(),
+    });
+}
+
+Result<ModMetadata> ModMetadataCache::load(std::filesystem::path const& path) {
+    auto key = utils::string::pathToString(path);
+    auto stamp = ModMetadataCache::stamp(path);
+
+    if (stamp) {
+        std::optional<CachedMetadata> cached;
+        {
+            std::unique_lock lock(m_impl->m_mutex);
+            m_impl->loadFromDisk();
+            auto it = m_impl->m_entries.find(key);
+            if (it != m_impl->m_entries.end() && it->second.stamp == stamp.unwrap()) {
+                cached = it->second;
+            }
+        }
+        if (cached) {
+            // Validating the JSON again is much cheaper than reading it out
+            // of the zip, and means the metadata behaves exactly the same
+            if (auto res = ModMetadata::create(cached->json)) {
+                auto info = res.unwrap();
+                auto& impl = ModMetadataImpl::getImpl(info);
+                impl.m_path = path;
+                if (cached->hasSpecialFiles) {
+                    impl.m_deferredSpecialFiles = std::make_shared<DeferredSpecialFiles>(path, stamp.unwrap());
+                }
+                std::unique_lock lock(m_impl->m_mutex);
+                m_impl->m_used.insert_or_assign(key, std::move(*cached));
+                return Ok(info);
+            }
+        }
+    }
+
+    GEODE_UNWRAP_INTO(auto info, ModMetadata::createFromGeodeFile(path));
+
+    if (stamp) {
+        std::unique_lock lock(m_impl->m_mutex);
+        m_impl->m_used.insert_or_assign(key, CachedMetadata {
+            .stamp = stamp.unwrap(),
+            .json = info.getRawJSON(),
+            .hasSpecialFiles =
+                info.getDetails().has_value() ||
+                info.getChangelog().has_value() ||
+                info.getSupportInfo().has_value(),
+        });
+        m_impl->m_dirty = true;
+    }
+    return Ok(info);
+}
+
+void ModMetadataCache::save() {
+    std::unique_lock lock(m_impl->m_mutex);
+
+    // Entries for packages that were removed also count as a change
+    if (!m_impl->m_dirty && m_impl->m_used.size() == m_impl->m_entries.size()) {
+        return;
+    }
+
+    auto mods = matjson::Value::object();
+    for (auto const& [path, entry] : m_impl->m_used) {
+        mods[path] = matjson::makeObject({
+            { "size", static_cast<int64_t>(entry.stamp.size) },
+            { "modified", entry.stamp.modified },
+            { "special-files", entry.hasSpecialFiles },
+            { "mod.json", entry.json },
+        });
+    }
+    auto json = matjson::makeObject({
+        { "version", CACHE_VERSION },
+        { "loader", Impl::getLoaderStamp() },
+        { "mods", mods },
+    });
+
+    (void)file::createDirectoryAll(Impl::getPath().parent_path());
+    if (auto res = file::writeStringSafe(Impl::getPath(), json.dump(matjson::NO_INDENTATION)); !res) {
+        log::warn("Unable to save mod metadata cache: {}", res.unwrapErr());
+        return;
+    }
+    m_impl->m_entries = m_impl->m_used;
+    m_impl->m_dirty = false;
+}
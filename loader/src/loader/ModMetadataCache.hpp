@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Geode/loader/ModMetadata.hpp>
+#include <filesystem>
+#include <memory>
+
+namespace geode {
+    /**
+     * On-disk index of the metadata of .geode packages, so that packages
+     * that haven't changed since the last launch don't need to be opened
+     * at all on startup. Entries are keyed by the path of the package and
+     * invalidated by its size and last modified time
+     */
+    class ModMetadataCache final {
+    private:
+        class Impl;
+        std::unique_ptr<Impl> m_impl;
+
+        ModMetadataCache();
+
+    public:
+        /**
+         * What a package is identified by in the cache; if either of these
+         * changed, the package has been replaced
+         */
+        struct PackageStamp {
+            uintmax_t size;
+            int64_t modified;
+
+            bool operator==(PackageStamp const&) const = default;
+        };
+
+        static ModMetadataCache* get();
+        ~ModMetadataCache();
+
+        static Result<PackageStamp> stamp(std::filesystem::path const& path);
+
+        /**
+         * Get the metadata of a .geode package, either from the cache if the
+         * package hasn't changed or from the package itself. Safe to call
+         * from multiple threads
+         */
+        Result<ModMetadata> load(std::filesystem::path const& path);
+
+        /**
+         * Write the cache to disk if anything has changed. Packages that
+         * haven't been loaded since the last save are dropped from it
+         */
+        void save();
+    };
+}
@@ -510,6 +510,7 @@ Result<ModMetadata> ModMetadata::Impl::createFromGeodeZip(file::Unzip& unzip) {
 }
 
 Result<> ModMetadata::Impl::addSpecialFiles(file::Unzip& unzip) {
+    this->resolveDeferredSpecialFiles();
     // unzip known MD files
     for (auto& [file, target] : this->getSpecialFiles()) {
         if (unzip.hasEntry(file)) {
@@ -525,6 +526,7 @@ Result<> ModMetadata::Impl::addSpecialFiles(file::Unzip& unzip) {
 }
 
 Result<> ModMetadata::Impl::addSpecialFiles(std::filesystem::path const& dir) {
+    this->resolveDeferredSpecialFiles();
     // unzip known MD files
     for (auto& [file, target] : this->getSpecialFiles()) {
         if (std::filesystem::exists(dir / file)) {
@@ -539,6 +541,7 @@ Result<> ModMetadata::Impl::addSpecialFiles(std::filesystem::path const& dir) {
 }
 
 std::vector<std::pair<std::string, std::optional<std::string>*>> ModMetadata::Impl::getSpecialFiles() {
+    this->resolveDeferredSpecialFiles();
     return {
         {"about.md", &this->m_details},
         {"changelog.md", &this->m_changelog},
@@ -546,6 +549,44 @@ std::vector<std::pair<std::string, std::optional<std::string>*>> ModMetadata::Im
     };
 }
 
+DeferredSpecialFiles const& ModMetadata::Impl::loadDeferredSpecialFiles() const {
+    auto deferred = m_deferredSpecialFiles.get();
+    std::call_once(deferred->loaded, [deferred] {
+        auto load = [&]() -> Result<> {
+            GEODE_UNWRAP_INTO(auto stamp, ModMetadataCache::stamp(deferred->package));
+            if (stamp != deferred->stamp) {
+                return Err("package has been replaced since its metadata was loaded");
+            }
+            GEODE_UNWRAP_INTO(auto unzip, file::Unzip::create(deferred->package));
+            ModMetadata::Impl files;
+            GEODE_UNWRAP(files.addSpecialFiles(unzip));
+            deferred->details = std::move(files.m_details);
+            deferred->changelog = std::move(files.m_changelog);
+            deferred->supportInfo = std::move(files.m_supportInfo);
+            return Ok();
+        };
+        if (auto res = load(); !res) {
+            log::warn("Unable to read extra files from {}: {}", deferred->package, res.unwrapErr());
+        }
+    });
+    return *deferred;
+}
+
+void ModMetadata::Impl::preloadDeferredSpecialFiles() const {
+    if (m_deferredSpecialFiles) {
+        this->loadDeferredSpecialFiles();
+    }
+}
+
+void ModMetadata::Impl::resolveDeferredSpecialFiles() {
+    if (!m_deferredSpecialFiles) return;
+    auto const& deferred = this->loadDeferredSpecialFiles();
+    m_details = deferred.details;
+    m_changelog = deferred.changelog;
+    m_supportInfo = deferred.supportInfo;
+    m_deferredSpecialFiles = nullptr;
+}
+
 ModJson ModMetadata::Impl::toJSON() const {
     auto json = m_rawJSON;
     json["path"] = this->m_path;
@@ -604,12 +645,21 @@ std::optional<std::string> ModMetadata::getDescription() const {
     return m_impl->m_description;
 }
 std::optional<std::string> ModMetadata::getDetails() const {
+    if (m_impl->m_deferredSpecialFiles) {
+        return m_impl->loadDeferredSpecialFiles().details;
+    }
     return m_impl->m_details;
 }
 std::optional<std::string> ModMetadata::getChangelog() const {
+    if (m_impl->m_deferredSpecialFiles) {
+        return m_impl->loadDeferredSpecialFiles().changelog;
+    }
     return m_impl->m_changelog;
 }
 std::optional<std::string> ModMetadata::getSupportInfo() const {
+    if (m_impl->m_deferredSpecialFiles) {
+        return m_impl->loadDeferredSpecialFiles().supportInfo;
+    }
     return m_impl->m_supportInfo;
 }
 ModMetadataLinks ModMetadata::getLinks() const {
@@ -731,12 +781,15 @@ void ModMetadata::setDescription(std::optional<std::string> const& value) {
     m_impl->m_description = value;
 }
 void ModMetadata::setDetails(std::optional<std::string> const& value) {
+    m_impl->resolveDeferredSpecialFiles();
     m_impl->m_details = value;
 }
 void ModMetadata::setChangelog(std::optional<std::string> const& value) {
+    m_impl->resolveDeferredSpecialFiles();
     m_impl->m_changelog = value;
 }
 void ModMetadata::setSupportInfo(std::optional<std::string> const& value) {
+    m_impl->resolveDeferredSpecialFiles();
     m_impl->m_supportInfo = value;
 }
 void ModMetadata::setRepository(std::optional<std::string> const& value) {
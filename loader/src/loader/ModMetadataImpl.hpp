@@ -5,7 +5,9 @@
 #include <Geode/utils/JsonValidation.hpp>
 #include <Geode/utils/VersionInfo.hpp>
 #include <Geode/loader/Setting.hpp>
+#include "ModMetadataCache.hpp"
 #include <compare>
+#include <mutex>
 
 using namespace geode::prelude;
 
@@ -77,6 +79,27 @@ namespace geode {
         std::optional<std::string> m_community;
     };
 
+    /**
+     * about.md, changelog.md and support.md of a mod whose metadata was
+     * loaded from the metadata cache. These are only needed by the UI, so
+     * they are read from the package the first time something asks for them.
+     * Shared between copies of the same metadata.
+     * If the package has been replaced since the metadata was loaded (as
+     * happens when a mod is updated in-game), its files belong to a
+     * different version and aren't read
+     */
+    struct DeferredSpecialFiles final {
+        std::filesystem::path package;
+        ModMetadataCache::PackageStamp stamp;
+        std::once_flag loaded;
+        std::optional<std::string> details;
+        std::optional<std::string> changelog;
+        std::optional<std::string> supportInfo;
+
+        DeferredSpecialFiles(std::filesystem::path package, ModMetadataCache::PackageStamp stamp)
+          : package(std::move(package)), stamp(stamp) {}
+    };
+
     class ModMetadata::Impl {
     public:
         std::filesystem::path m_path;
@@ -92,6 +115,8 @@ namespace geode {
         std::optional<std::string> m_details;
         std::optional<std::string> m_changelog;
         std::optional<std::string> m_supportInfo;
+        // If set, the three above haven't been read from the package yet
+        std::shared_ptr<DeferredSpecialFiles> m_deferredSpecialFiles;
         ModMetadataLinks m_links;
         std::optional<IssuesInfo> m_issues;
         std::vector<Dependency> m_dependencies;
@@ -130,6 +155,13 @@ namespace geode {
         Result<> addSpecialFiles(utils::file::Unzip& zip);
 
         std::vector<std::pair<std::string, std::optional<std::string>*>> getSpecialFiles();
+
+        DeferredSpecialFiles const& loadDeferredSpecialFiles() const;
+        // Reads the deferred special files into this metadata so they can be modified
+        void resolveDeferredSpecialFiles();
+        // Reads the deferred special files (if any) now, for when the package
+        // is about to be replaced; every copy of this metadata keeps them
+        void preloadDeferredSpecialFiles() const;
     };
 
     class ModMetadataImpl : public ModMetadata::Impl {
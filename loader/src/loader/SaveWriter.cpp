@@ -0,0 +1,75 @@
+#include "SaveWriter.hpp"
+
+#include <Geode/loader/Log.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/string.hpp>
+#include <Geode/utils/general.hpp>
+#include <cstdlib>
+#include <thread>
+
+using namespace geode::prelude;
+
+SaveWriter* SaveWriter::get() {
+    // Never destroyed, as the writer thread may still be running at exit
+    static auto inst = new SaveWriter();
+    return inst;
+}
+
+void SaveWriter::queue(std::filesystem::path path, std::string contents, std::string modID) {
+    {
+        std::lock_guard lock(m_queueMutex);
+        m_queue.insert_or_assign(std::move(path), PendingWrite {
+            .contents = std::move(contents),
+            .modID = std::move(modID),
+        });
+        if (!m_started) {
+            m_started = true;
+            std::thread([this] {
+                thread::setName("Save Writer");
+                this->runWriter();
+            }).detach();
+
+            std::atexit([] {
+                SaveWriter::get()->flush();
+            });
+        }
+    }
+    m_wakeCV.notify_one();
+}
+
+void SaveWriter::runWriter() {
+    while (true) {
+        {
+            std::unique_lock lock(m_queueMutex);
+            m_wakeCV.wait(lock, [this] { return !m_queue.empty(); });
+        }
+        std::lock_guard g(m_writeMutex);
+        this->writeQueued();
+    }
+}
+
+void SaveWriter::writeQueued() {
+    while (true) {
+        decltype(m_queue)::node_type node;
+        {
+            std::lock_guard lock(m_queueMutex);
+            if (m_queue.empty()) {
+                return;
+            }
+            node = m_queue.extract(m_queue.begin());
+        }
+        auto& write = node.mapped();
+        auto res = file::writeStringSafe(node.key(), write.contents);
+        if (!res) {
+            log::error(
+                "Unable to save {} for mod {}: {}",
+                utils::string::pathToString(node.key().filename()), write.modID, res.unwrapErr()
+            );
+        }
+    }
+}
+
+void SaveWriter::flush() {
+    std::lock_guard g(m_writeMutex);
+    this->writeQueued();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Geode/DefaultInclude.hpp>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace geode {
+    /**
+     * Writes mod save files on a background thread, so that saving the game
+     * doesn't have to wait for every mod's files to hit the disk. Only the
+     * latest contents queued for a file are kept, so a file queued again
+     * before the writer gets to it is only written once
+     */
+    class SaveWriter final {
+    private:
+        struct PendingWrite {
+            std::string contents;
+            std::string modID;
+        };
+
+        std::mutex m_queueMutex;
+        std::map<std::filesystem::path, PendingWrite> m_queue;
+        std::condition_variable m_wakeCV;
+        // Held by whoever is currently writing files out
+        std::mutex m_writeMutex;
+        bool m_started = false;
+
+        SaveWriter() = default;
+
+        void runWriter();
+        // Must be called with m_writeMutex locked
+        void writeQueued();
+
+    public:
+        static SaveWriter* get();
+
+        /**
+         * Queue a file to be written out with `writeStringSafe`. Errors are
+         * logged, mentioning the mod the file belongs to
+         */
+        void queue(std::filesystem::path path, std::string contents, std::string modID);
+
+        /**
+         * Wait until every file queued so far has been written. Called at the
+         * end of every game save and at exit, so nothing queued is ever lost
+         * to the game closing
+         */
+        void flush();
+    };
+}
@@ -0,0 +1,117 @@
+#include "UnzipManifest.hpp"
+
+#include <Geode/utils/file.hpp>
+#include <matjson.hpp>
+#include <algorithm>
+#include <vector>
+
+using namespace geode::prelude;
+
+static std::filesystem::path pathFromManifest(std::string const& name) {
+    return std::filesystem::path(std::u8string(name.begin(), name.end()));
+}
+
+// Manifest names come from the zip, which always uses forward slashes
+static std::string manifestNameFromPath(std::filesystem::path const& path) {
+    auto name = path.generic_u8string();
+    return std::string(name.begin(), name.end());
+}
+
+bool geode::isInsideDir(std::filesystem::path const& dir, std::filesystem::path const& path) {
+    auto relative = path.lexically_normal().lexically_relative(dir.lexically_normal());
+    return !relative.empty() && *relative.begin() != ".." && *relative.begin() != ".";
+}
+
+std::optional<UnzipManifest> geode::readUnzipManifest(std::filesystem::path const& path) {
+    auto json = file::readJson(path);
+    if (!json || !json.unwrap().isArray()) {
+        return std::nullopt;
+    }
+    UnzipManifest manifest;
+    for (auto const& item : json.unwrap()) {
+        auto name = item["name"].asString();
+        auto crc32 = item["crc32"].asUInt();
+        auto size = item["size"].asUInt();
+        if (!name || !crc32 || !size) {
+            return std::nullopt;
+        }
+        manifest[name.unwrap()] = UnzipManifestEntry {
+            .crc32 = static_cast<uint32_t>(crc32.unwrap()),
+            .size = size.unwrap(),
+        };
+    }
+    return manifest;
+}
+
+Result<> geode::writeUnzipManifest(std::filesystem::path const& path, UnzipManifest const& manifest) {
+    // An array rather than an object keyed by name, since texture packs can
+    // have thousands of entries and inserting into an object checks the keys
+    auto json = matjson::Value::array();
+    for (auto const& [name, entry] : manifest) {
+        auto item = matjson::Value::object();
+        item["name"] = name;
+        item["crc32"] = entry.crc32;
+        item["size"] = entry.size;
+        json.push(std::move(item));
+    }
+    return file::writeStringSafe(path, json.dump(matjson::NO_INDENTATION));
+}
+
+std::unordered_set<std::string> geode::findChangedUnzipEntries(
+    std::filesystem::path const& dir,
+    UnzipManifest const& previous,
+    UnzipManifest const& current
+) {
+    std::unordered_set<std::string> changed;
+    for (auto const& [name, entry] : current) {
+        auto old = previous.find(name);
+        std::error_code ec;
+        if (
+            old != previous.end() && old->second == entry &&
+            std::filesystem::file_size(dir / pathFromManifest(name), ec) == entry.size && !ec
+        ) {
+            continue;
+        }
+        changed.insert(name);
+    }
+    return changed;
+}
+
+size_t geode::removeUntrackedUnzipFiles(
+    std::filesystem::path const& dir,
+    UnzipManifest const& manifest,
+    std::unordered_set<std::string> const& keep
+) {
+    // Collect first, since removing files while iterating is unspecified
+    std::vector<std::filesystem::path> untracked;
+    std::error_code ec;
+    for (
+        auto it = std::filesystem::recursive_directory_iterator(dir, ec);
+        !ec && it != std::filesystem::recursive_directory_iterator();
+        it.increment(ec)
+    ) {
+        if (it->is_directory(ec)) {
+            continue;
+        }
+        auto name = manifestNameFromPath(it->path().lexically_relative(dir));
+        if (manifest.contains(name) || keep.contains(name)) {
+            continue;
+        }
+        untracked.push_back(it->path());
+    }
+
+    size_t removed = 0;
+    for (auto const& path : untracked) {
+        if (!std::filesystem::remove(path, ec)) {
+            continue;
+        }
+        removed += 1;
+        // Clean up the directories that are left empty
+        for (auto parent = path.parent_path(); isInsideDir(dir, parent); parent = parent.parent_path()) {
+            if (!std::filesystem::remove(parent, ec)) {
+                break;
+            }
+        }
+    }
+    return removed;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Geode/Result.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace geode {
+    struct UnzipManifestEntry {
+        uint32_t crc32;
+        uint64_t size;
+
+        bool operator==(UnzipManifestEntry const&) const = default;
+    };
+    // Keyed by the entry's path in the zip
+    using UnzipManifest = std::unordered_map<std::string, UnzipManifestEntry>;
+
+    /**
+     * Whether `path` is strictly inside `dir`, without touching the disk. Used
+     * to keep zip entries like `../file` from escaping the directory
+     */
+    bool isInsideDir(std::filesystem::path const& dir, std::filesystem::path const& path);
+
+    std::optional<UnzipManifest> readUnzipManifest(std::filesystem::path const& path);
+    Result<> writeUnzipManifest(std::filesystem::path const& path, UnzipManifest const& manifest);
+
+    /**
+     * Find the entries of `current` that need to be extracted into `dir`,
+     * which are the ones that aren't in `previous` with the same CRC-32 and
+     * size, or whose file in `dir` doesn't have the right size anymore
+     */
+    std::unordered_set<std::string> findChangedUnzipEntries(
+        std::filesystem::path const& dir,
+        UnzipManifest const& previous,
+        UnzipManifest const& current
+    );
+
+    /**
+     * Remove every file in `dir` that isn't an entry of `manifest`, along
+     * with the directories that are left empty. This covers both entries that
+     * were removed from the zip and files that were never extracted from it
+     * @param keep Names of files directly in `dir` that aren't in the zip but
+     * should be kept anyway
+     * @returns The number of files removed
+     */
+    size_t removeUntrackedUnzipFiles(
+        std::filesystem::path const& dir,
+        UnzipManifest const& manifest,
+        std::unordered_set<std::string> const& keep
+    );
+}
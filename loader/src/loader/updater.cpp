@@ -124,11 +124,13 @@ void updater::tryDownloadLoaderResources(std::string const& url, bool tryLatestO
     if (RUNNING_REQUESTS.contains(url)) return;
 
     auto req = web::WebRequest();
+    // download straight to disk rather than keeping the whole zip in memory
+    req.downloadTo(tempResourcesZip);
     RUNNING_REQUESTS.emplace(url, req.get(url).map(
-        [url, resourcesDir](web::WebResponse* response) {
+        [url, resourcesDir, tempResourcesZip](web::WebResponse* response) {
             if (response->ok()) {
                 // unzip resources zip
-                auto unzip = file::Unzip::create(response->data());
+                auto unzip = file::Unzip::create(tempResourcesZip);
                 if (unzip) {
                     auto ok = unzip.unwrap().extractAllTo(resourcesDir);
                     if (ok) {
@@ -297,13 +299,14 @@ void updater::downloadLoaderUpdate(std::string const& url) {
     if (RUNNING_REQUESTS.contains("@downloadLoaderUpdate")) return;
 
     auto req = web::WebRequest();
+    req.downloadTo(updateZip);
     RUNNING_REQUESTS.emplace(
         "@downloadLoaderUpdate",
         req.get(url).map(
-            [targetDir](web::WebResponse* response) {
+            [targetDir, updateZip](web::WebResponse* response) {
                 if (response->ok()) {
                     // unzip resources zip
-                    auto unzip = file::Unzip::create(response->data());
+                    auto unzip = file::Unzip::create(updateZip);
                     if (unzip) {
                         auto ok = unzip.unwrap().extractAllTo(targetDir);
                         if (ok) {
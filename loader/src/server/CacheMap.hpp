@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace server {
+    struct CacheEntrySize final {
+        size_t bytes;
+        // False if the value can't be sized properly yet (like a request that
+        // is still running), in which case it gets sized again on later trims
+        bool final;
+    };
+
+    /**
+     * A least recently used cache that keeps the estimated size of its values
+     * within a byte budget
+     * @tparam SizeOf Callable that estimates the size of a value
+     */
+    template <class K, class V, class SizeOf>
+        requires std::equality_comparable<K> && std::copy_constructible<K> &&
+            std::is_invocable_r_v<CacheEntrySize, SizeOf, V&>
+    class CacheMap final {
+    private:
+        struct Entry {
+            K key;
+            V value;
+            CacheEntrySize size;
+        };
+
+        // Ordered from least to most recently used.
+        //
+        // The keys (like ModsQuery) aren't hashable, but even with a byte budget
+        // the cache holds a few hundred items at most, and linear searching those
+        // is still nothing compared to the web request it saves
+        std::vector<Entry> m_values;
+        size_t m_sizeLimit = 20 * 1024 * 1024;
+        size_t m_size = 0;
+
+        void updateSizes() {
+            for (auto& entry : m_values) {
+                if (!entry.size.final) {
+                    m_size -= entry.size.bytes;
+                    entry.size = SizeOf()(entry.value);
+                    m_size += entry.size.bytes;
+                }
+            }
+        }
+
+        // Evict the least recently used items until the cache fits its limit,
+        // always keeping the most recently used one
+        size_t trim() {
+            this->updateSizes();
+            size_t evict = 0;
+            while (m_size > m_sizeLimit && evict + 1 < m_values.size()) {
+                m_size -= m_values[evict].size.bytes;
+                evict += 1;
+            }
+            if (evict) {
+                m_values.erase(m_values.begin(), m_values.begin() + evict);
+            }
+            return evict;
+        }
+
+    public:
+        std::optional<V> get(K const& key) {
+            auto it = std::find_if(m_values.begin(), m_values.end(), [&key](auto const& entry) {
+                return entry.key == key;
+            });
+            if (it == m_values.end()) {
+                return std::nullopt;
+            }
+            // Move to the most recently used end
+            std::rotate(it, it + 1, m_values.end());
+            return m_values.back().value;
+        }
+        /**
+         * @returns The number of items evicted to make room
+         */
+        size_t add(K&& key, V&& value) {
+            auto size = SizeOf()(value);
+            m_size += size.bytes;
+            m_values.push_back(Entry {
+                .key = std::move(key),
+                .value = std::move(value),
+                .size = size,
+            });
+            return this->trim();
+        }
+        void remove(K const& key) {
+            std::erase_if(m_values, [&](auto const& entry) {
+                if (entry.key == key) {
+                    m_size -= entry.size.bytes;
+                    return true;
+                }
+                return false;
+            });
+        }
+        void clear() {
+            m_values.clear();
+            m_size = 0;
+        }
+        /**
+         * @returns The number of items evicted to fit the new limit
+         */
+        size_t limit(size_t bytes) {
+            m_sizeLimit = bytes;
+            return this->trim();
+        }
+        size_t size() const {
+            return m_values.size();
+        }
+        size_t limit() const {
+            return m_sizeLimit;
+        }
+        /**
+         * The estimated size of every value in the cache, as of the last
+         * time the values were sized
+         */
+        size_t bytes() const {
+            return m_size;
+        }
+    };
+}
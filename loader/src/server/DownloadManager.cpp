@@ -4,9 +4,16 @@
 #include <Geode/utils/map.hpp>
 #include <fmt/format.h>
 #include <optional>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 #include <hash/hash.hpp>
 #include <loader/LoaderImpl.hpp>
 #include <loader/ModImpl.hpp>
+#include <loader/ModMetadataImpl.hpp>
 
 using namespace server;
 
@@ -21,7 +28,170 @@ ListenerResult ModDownloadFilter::handle(std::function<Callback> fn, ModDownload
 ModDownloadFilter::ModDownloadFilter() {}
 ModDownloadFilter::ModDownloadFilter(std::string const& id) : m_id(id) {}
 
-class ModDownload::Impl final {
+// How many times a download is attempted before giving up, resuming
+// from what was already downloaded each time
+static constexpr size_t MAX_DOWNLOAD_ATTEMPTS = 3;
+static constexpr size_t INITIAL_PARALLEL_DOWNLOADS = 2;
+static constexpr size_t MAX_PARALLEL_DOWNLOADS = 6;
+
+// Decides how many mod downloads run at once. Starts with a couple in
+// parallel and only allows more while doing so actually increases the
+// total throughput, so that a slow connection doesn't get split between
+// a dozen downloads that all crawl along. Only used from the main thread
+class DownloadScheduler final {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::deque<std::pair<std::string, std::function<void()>>> m_queue;
+    std::unordered_set<std::string> m_running;
+    size_t m_limit = INITIAL_PARALLEL_DOWNLOADS;
+
+    uint64_t m_windowBytes = 0;
+    Clock::time_point m_windowStart = Clock::now();
+    // Set while checking whether the last raise of the limit helped
+    std::optional<double> m_rateBeforeProbe;
+    Clock::time_point m_noProbeUntil;
+
+    void startQueued() {
+        while (m_running.size() < m_limit && !m_queue.empty()) {
+            auto [id, start] = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_running.insert(id);
+            start();
+        }
+    }
+    void resetWindow() {
+        m_windowBytes = 0;
+        m_windowStart = Clock::now();
+        m_rateBeforeProbe = std::nullopt;
+    }
+
+public:
+    static DownloadScheduler* get() {
+        static auto inst = new DownloadScheduler();
+        return inst;
+    }
+
+    void enqueue(std::string const& id, std::function<void()> start) {
+        if (m_running.empty()) {
+            this->resetWindow();
+        }
+        m_queue.emplace_back(id, std::move(start));
+        this->startQueued();
+    }
+    void finished(std::string const& id) {
+        std::erase_if(m_queue, [&](auto const& queued) { return queued.first == id; });
+        if (m_running.erase(id)) {
+            this->startQueued();
+        }
+    }
+    void reportProgress(uint64_t bytes) {
+        m_windowBytes += bytes;
+        auto now = Clock::now();
+        auto elapsed = std::chrono::duration<double>(now - m_windowStart).count();
+        if (elapsed < 2.0) return;
+        auto rate = m_windowBytes / elapsed;
+        m_windowBytes = 0;
+        m_windowStart = now;
+
+        if (m_rateBeforeProbe) {
+            // If the extra download didn't make things meaningfully faster,
+            // the connection is saturated; go back and stay there for a while
+            if (rate < *m_rateBeforeProbe * 1.1 && m_limit > 1) {
+                m_limit -= 1;
+                m_noProbeUntil = now + std::chrono::seconds(30);
+            }
+            m_rateBeforeProbe = std::nullopt;
+        }
+        else if (
+            !m_queue.empty() && m_running.size() >= m_limit &&
+            m_limit < MAX_PARALLEL_DOWNLOADS && now >= m_noProbeUntil
+        ) {
+            m_rateBeforeProbe = rate;
+            m_limit += 1;
+            this->startQueued();
+        }
+    }
+};
+
+// The state of a download's .part file. Chunks are hashed and written by
+// the request's background writer (see WebRequest::onChunkAsync), so the
+// web thread that drives every transfer never waits for the disk
+struct PartialDownload final : public std::enable_shared_from_this<PartialDownload> {
+    std::filesystem::path path;
+    SHA256Hasher hasher;
+    // How much of the .part file was there already when the request started
+    std::atomic<uint64_t> resumedFrom = 0;
+    // Only touched by whoever is writing to the file; safe to read on the
+    // main thread once the request has finished
+    std::optional<std::string> error;
+    std::atomic_bool failed = false;
+
+    // Protects the file and everything below, so that closing it waits for
+    // a write that is still in progress
+    std::mutex mutex;
+    std::ofstream file;
+    bool restart = false;
+    bool closed = false;
+
+    // Expects mutex to be held
+    void fail(std::string message) {
+        error = std::move(message);
+        failed = true;
+    }
+
+    // Called on the web thread; throws away what was downloaded before
+    void startOver() {
+        std::unique_lock lock(mutex);
+        restart = true;
+        resumedFrom = 0;
+    }
+
+    // Called on the request's writer thread
+    bool write(std::span<uint8_t const> data) {
+        std::unique_lock lock(mutex);
+        if (closed || failed) {
+            return false;
+        }
+        if (restart) {
+            restart = false;
+            file.close();
+            file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+            hasher.reset();
+            if (!file) {
+                this->fail(fmt::format("Unable to open {} for writing", path));
+                return false;
+            }
+        }
+        hasher.update(data);
+        if (!file.write(reinterpret_cast<char const*>(data.data()), data.size())) {
+            this->fail(fmt::format("Unable to write to {}", path));
+            return false;
+        }
+        return true;
+    }
+
+    // Closes the .part file for good. Waits for a write in progress, so
+    // this must not be called on the main thread
+    void closeNow() {
+        std::unique_lock lock(mutex);
+        closed = true;
+        file.close();
+    }
+
+    // Closes the .part file on the blocking executor, and then queues
+    // `callback` in the main thread if there is one
+    void close(std::function<void()> callback) {
+        utils::thread::Executor::getBlocking()->submit([self = shared_from_this(), callback = std::move(callback)] {
+            self->closeNow();
+            if (callback) {
+                Loader::get()->queueInMainThread(std::move(callback));
+            }
+        });
+    }
+};
+
+class ModDownload::Impl final : public std::enable_shared_from_this<ModDownload::Impl> {
 public:
     std::string m_id;
     std::optional<VersionInfo> m_version;
@@ -31,6 +201,9 @@ public:
     EventListener<ServerRequest<ServerModVersion>> m_infoListener;
     EventListener<web::WebTask> m_downloadListener;
     unsigned int m_scheduledEventForFrame = 0;
+    std::shared_ptr<PartialDownload> m_partial;
+    size_t m_attempts = 0;
+    size_t m_lastDownloaded = 0;
 
     Impl(
         std::string const& id,
@@ -103,6 +276,228 @@ public:
         });
     }
 
+    void start(std::string const& downloadURL, std::string const& hash) {
+        m_attempts += 1;
+        m_lastDownloaded = 0;
+
+        auto partial = std::make_shared<PartialDownload>();
+        partial->path = dirs::getTempDir() / "downloads" / m_id / (hash + ".part");
+        // The previous attempt's writer may still be finishing up with the
+        // same .part file, so it has to be closed before it's opened again
+        auto previous = std::exchange(m_partial, partial);
+
+        // Preparing the .part file means hashing whatever was downloaded
+        // already, which is way too slow to do on the main thread for large
+        // mods. Retries also back off here so a dropped connection has some
+        // time to come back
+        auto delay = std::chrono::seconds(m_attempts > 1 ? 2 << (m_attempts - 2) : 0);
+        auto prepare = Task<void>::runOn(utils::thread::Executor::getBlocking(), [partial, previous, delay](auto, auto) {
+            if (previous) {
+                previous->closeNow();
+            }
+            std::this_thread::sleep_for(delay);
+
+            std::error_code ec;
+            auto dir = partial->path.parent_path();
+            std::filesystem::create_directories(dir, ec);
+            // Leftovers from downloading other versions of this mod can't
+            // be resumed anymore
+            for (auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+                if (entry.path() != partial->path) {
+                    std::filesystem::remove(entry.path(), ec);
+                }
+            }
+
+            auto size = std::filesystem::file_size(partial->path, ec);
+            if (!ec && size > 0) {
+                // If the file couldn't be read back fully, it can't be trusted
+                if (partial->hasher.update(partial->path, size) == size) {
+                    partial->resumedFrom = size;
+                }
+                else {
+                    partial->hasher.reset();
+                }
+            }
+            partial->file.open(
+                partial->path,
+                std::ios::out | std::ios::binary | (partial->resumedFrom > 0 ? std::ios::app : std::ios::trunc)
+            );
+            if (!partial->file) {
+                std::unique_lock lock(partial->mutex);
+                partial->fail(fmt::format("Unable to open {} for writing", partial->path));
+            }
+            return true;
+        }, "Prepare mod download");
+
+        m_downloadListener.setFilter(prepare.chain([partial, downloadURL](auto) {
+            auto req = web::WebRequest();
+            req.userAgent(getServerUserAgent());
+            if (partial->resumedFrom > 0) {
+                req.downloadRange({ partial->resumedFrom.load(), std::numeric_limits<uint64_t>::max() });
+            }
+            req.onStreamStart([partial](int code) {
+                if (partial->failed) {
+                    return false;
+                }
+                // The server ignored the range and is sending the whole
+                // file, so start over
+                if (partial->resumedFrom > 0 && code != 206) {
+                    partial->startOver();
+                }
+                return true;
+            });
+            req.onChunkAsync([partial](std::span<uint8_t const> data) {
+                return partial->write(data);
+            });
+            return req.get(downloadURL);
+        }));
+    }
+
+    // Called once the transfer is over and the .part file has been closed;
+    // checks the download and moves it into place
+    void onDownloaded(
+        web::WebResponse const& response, std::string const& downloadURL,
+        std::string const& hash, ServerModVersion const& version
+    ) {
+        auto partial = m_partial;
+
+        // If the .part file already had everything, there's nothing
+        // left for the range request to get
+        auto alreadyComplete = response.code() == 416 && partial->resumedFrom > 0;
+
+        if (!response.ok() && !alreadyComplete) {
+            auto resp = &response;
+
+            // Network errors and server hiccups are worth another
+            // try, which continues from where this one stopped
+            if (
+                (resp->code() == -1 || resp->code() >= 500) &&
+                !partial->error && m_attempts < MAX_DOWNLOAD_ATTEMPTS
+            ) {
+                log::warn(
+                    "Download of {} was interrupted (code {}), retrying (attempt {}/{})",
+                    m_id, resp->code(), m_attempts + 1, MAX_DOWNLOAD_ATTEMPTS
+                );
+                this->start(downloadURL, hash);
+                return;
+            }
+
+            if (partial->error) {
+                m_status = DownloadStatusError {
+                    .details = *partial->error,
+                };
+            } else if (resp->code() == -1) {
+                m_status = DownloadStatusError {
+                    .details = fmt::format(
+                        "Failed to make request to download endpoint. Error: {}",
+                        resp->string().unwrapOr("No message")
+                    )
+                };
+            } else {
+                m_status = DownloadStatusError {
+                    .details = fmt::format(
+                        "Server returned error {} with message: {}",
+                        resp->code(),
+                        resp->string().unwrapOr("No message")
+                    )
+                };
+            }
+
+            log::error("Failed to download {}, server returned error {}", m_id, resp->code());
+            log::error("{}", resp->string().unwrapOr("No response"));
+
+            const auto& extErr = resp->errorMessage();
+            if (!extErr.empty()) {
+                log::error("Extended error info: {}", extErr);
+            }
+            return;
+        }
+
+        // The file was hashed as it was downloaded, so this is
+        // only a matter of finishing the digest
+        if (auto actualHash = partial->hasher.digest(); actualHash != hash) {
+            log::error("Failed to download {}, hash mismatch ({} != {})", m_id, actualHash, hash);
+            // Whatever is in the .part file is no good for resuming
+            std::error_code ec;
+            std::filesystem::remove(partial->path, ec);
+            m_status = DownloadStatusError {
+                .details = "Hash mismatch, downloaded file did not match what was expected",
+            };
+            return;
+        }
+
+        std::string id = m_replacesMod.has_value() ? m_replacesMod.value() : m_id;
+        if (auto mod = Loader::get()->getInstalledMod(id)) {
+            // The installed version's about.md and such may not have been
+            // read out of its package yet, and this is the last chance to
+            ModMetadataImpl::getImpl(ModImpl::getImpl(mod)->m_metadata).preloadDeferredSpecialFiles();
+
+            std::error_code ec;
+            std::filesystem::remove(mod->getPackagePath(), ec);
+            if (ec) {
+                m_status = DownloadStatusError {
+                    .details = fmt::format("Unable to delete existing .geode package (code {})", ec),
+                };
+                return;
+            }
+            // Mark mod as updated
+            ModImpl::getImpl(mod)->m_requestedAction = ModRequestedAction::Update;
+        }
+
+        // Move the finished download into place
+        auto geodePath = dirs::getModsDir() / (m_id + ".geode");
+        std::error_code ec;
+        std::filesystem::rename(partial->path, geodePath, ec);
+        if (ec) {
+            // Renaming doesn't work across drives
+            ec.clear();
+            std::filesystem::copy_file(
+                partial->path, geodePath, std::filesystem::copy_options::overwrite_existing, ec
+            );
+            if (ec) {
+                m_status = DownloadStatusError {
+                    .details = fmt::format("Unable to move downloaded file to {}: {}", geodePath, ec.message()),
+                };
+                return;
+            }
+        }
+        std::filesystem::remove_all(partial->path.parent_path(), ec);
+
+        auto metadata = ModMetadata::createFromGeodeFile(geodePath);
+        if (metadata.isErr()) {
+            m_status = DownloadStatusError {
+                .details = metadata.unwrapErr(),
+            };
+            return;
+        }
+
+        auto okBinary = LoaderImpl::get()->extractBinary(metadata.unwrap());
+        if (!okBinary) {
+            m_status = DownloadStatusError {
+                .details = okBinary.unwrapErr(),
+            };
+            return;
+        }
+
+        m_status = DownloadStatusDone {
+            .version = version
+        };
+    }
+
+    void postStatus() {
+        if (!std::holds_alternative<DownloadStatusDownloading>(m_status)) {
+            DownloadScheduler::get()->finished(m_id);
+        }
+        // Throttle events to only once per frame to not cause a
+        // billion UI updates at once
+        if (m_scheduledEventForFrame != CCDirector::get()->getTotalFrames()) {
+            m_scheduledEventForFrame = CCDirector::get()->getTotalFrames();
+            Loader::get()->queueInMainThread([id = m_id]() {
+                ModDownloadEvent(id).post();
+            });
+        }
+    }
+
     void confirm() {
         auto confirm = std::get_if<DownloadStatusConfirm>(&m_status);
         if (!confirm) return;
@@ -113,114 +508,47 @@ public:
         m_status = DownloadStatusDownloading {
             .percentage = 0,
         };
+        m_attempts = 0;
 
-        m_downloadListener.bind([this, hash = std::move(version.hash), version = std::move(version)](web::WebTask::Event* event) {
+        m_downloadListener.bind([this, downloadURL, hash = version.hash, version = version](web::WebTask::Event* event) {
             if (auto value = event->getValue()) {
-                if (!value->ok()) {
-                    auto resp = event->getValue();
-
-                    if (resp->code() == -1) {
-                        m_status = DownloadStatusError {
-                            .details = fmt::format(
-                                "Failed to make request to download endpoint. Error: {}",
-                                resp->string().unwrapOr("No message")
-                            )
-                        };
-                    } else {
-                        m_status = DownloadStatusError {
-                            .details = fmt::format(
-                                "Server returned error {} with message: {}",
-                                resp->code(),
-                                resp->string().unwrapOr("No message")
-                            )
-                        };
-                    }
-
-                    log::error("Failed to download {}, server returned error {}", m_id, resp->code());
-                    log::error("{}", resp->string().unwrapOr("No response"));
-
-                    const auto& extErr = resp->errorMessage();
-                    if (!extErr.empty()) {
-                        log::error("Extended error info: {}", extErr);
+                // Everything downloaded has been written by now, but the
+                // file still has to be closed before it can be looked at
+                m_partial->close([self = weak_from_this(), response = *value, downloadURL, hash, version] {
+                    if (auto impl = self.lock()) {
+                        impl->onDownloaded(response, downloadURL, hash, version);
+                        impl->postStatus();
                     }
-                    goto postdownloadedevent;
-                }
-
-                if (auto actualHash = ::calculateHash(value->data()); actualHash != hash) {
-                    log::error("Failed to download {}, hash mismatch ({} != {})", m_id, actualHash, hash);
-                    m_status = DownloadStatusError {
-                        .details = "Hash mismatch, downloaded file did not match what was expected",
-                    };
-                    goto postdownloadedevent;
-                }
-
-                std::string id = m_replacesMod.has_value() ? m_replacesMod.value() : m_id;
-                if (auto mod = Loader::get()->getInstalledMod(id)) {
-                    std::error_code ec;
-                    std::filesystem::remove(mod->getPackagePath(), ec);
-                    if (ec) {
-                        m_status = DownloadStatusError {
-                            .details = fmt::format("Unable to delete existing .geode package (code {})", ec),
-                        };
-                        goto postdownloadedevent;
-                    }
-                    // Mark mod as updated
-                    ModImpl::getImpl(mod)->m_requestedAction = ModRequestedAction::Update;
-                }
-
-                // If this was an update, delete the old file first
-                auto geodePath = dirs::getModsDir() / (m_id + ".geode");
-                auto ok = file::writeBinary(geodePath, value->data());
-                if (!ok) {
-                    m_status = DownloadStatusError {
-                        .details = ok.unwrapErr(),
-                    };
-                    goto postdownloadedevent;
-                }
-
-                auto metadata = ModMetadata::createFromGeodeFile(geodePath);
-                if (metadata.isErr()) {
-                    m_status = DownloadStatusError {
-                        .details = metadata.unwrapErr(),
-                    };
-                    goto postdownloadedevent;
-                }
-
-                auto okBinary = LoaderImpl::get()->extractBinary(metadata.unwrap());
-                if (!okBinary) {
-                    m_status = DownloadStatusError {
-                        .details = okBinary.unwrapErr(),
-                    };
-                    goto postdownloadedevent;
-                }
-
-                m_status = DownloadStatusDone {
-                    .version = version
-                };
+                });
+                return;
             }
             else if (auto progress = event->getProgress()) {
+                auto downloaded = progress->downloaded();
+                DownloadScheduler::get()->reportProgress(downloaded - std::min(downloaded, m_lastDownloaded));
+                m_lastDownloaded = downloaded;
+
+                // Progress is only reported for the part that is still
+                // being downloaded
+                auto resumedFrom = m_partial->resumedFrom.load();
+                auto total = resumedFrom + progress->downloadTotal();
                 m_status = DownloadStatusDownloading {
-                    .percentage = static_cast<uint8_t>(progress->downloadProgress().value_or(0)),
+                    .percentage = static_cast<uint8_t>(total > 0 ? (resumedFrom + downloaded) * 100 / total : 0),
                 };
             }
             else if (event->isCancelled()) {
                 m_status = DownloadStatusCancelled();
             }
-            // Throttle events to only once per frame to not cause a
-            // billion UI updates at once
-            postdownloadedevent:
-
-            if (m_scheduledEventForFrame != CCDirector::get()->getTotalFrames()) {
-                m_scheduledEventForFrame = CCDirector::get()->getTotalFrames();
-                Loader::get()->queueInMainThread([id = m_id]() {
-                    ModDownloadEvent(id).post();
-                });
-            }
+            this->postStatus();
         });
 
-        auto req = web::WebRequest();
-        req.userAgent(getServerUserAgent());
-        m_downloadListener.setFilter(req.get(downloadURL));
+        DownloadScheduler::get()->enqueue(m_id, [self = weak_from_this(), id = m_id, downloadURL, hash = version.hash] {
+            if (auto impl = self.lock()) {
+                impl->start(downloadURL, hash);
+            }
+            else {
+                DownloadScheduler::get()->finished(id);
+            }
+        });
         ModDownloadEvent(m_id).post();
     }
 };
@@ -300,6 +628,10 @@ void ModDownload::cancel() {
         m_impl->m_infoListener.setFilter(ServerRequest<ServerModVersion>());
         m_impl->m_downloadListener.getFilter().cancel();
         m_impl->m_downloadListener.setFilter({});
+        if (m_impl->m_partial) {
+            m_impl->m_partial->close(nullptr);
+        }
+        DownloadScheduler::get()->finished(m_impl->m_id);
 
         // Cancel any dependencies of this mod left over (unless some other
         // installation depends on them still)
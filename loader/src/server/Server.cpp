@@ -1,7 +1,12 @@
 #include "Server.hpp"
+#include "CacheMap.hpp"
+#include <Geode/loader/Dirs.hpp>
 #include <Geode/utils/JsonValidation.hpp>
+#include <Geode/utils/file.hpp>
 #include <Geode/utils/ranges.hpp>
+#include <atomic>
 #include <chrono>
+#include <mutex>
 #include <date/date.h>
 #include <fmt/core.h>
 #include <loader/ModMetadataImpl.hpp>
@@ -14,76 +19,276 @@ using namespace server;
 
 #define GEODE_GD_VERSION_STR GEODE_STR(GEODE_GD_VERSION)
 
-template <class K, class V>
-    requires std::equality_comparable<K> && std::copy_constructible<K>
-class CacheMap final {
-private:
-    // I know this looks like a goofy choice over just
-    // `std::unordered_map`, but hear me out:
-    //
-    // This needs preserved insertion order (so shrinking the cache
-    // to match size limits doesn't just have to erase random
-    // elements)
-    //
-    // If this used a map for values and another vector for storing
-    // insertion order, it would have a pretty big memory footprint
-    // (two copies of Query, one for order, one for map + two heap
-    // allocations on top of that)
-    //
-    // In addition, it would be a bad idea to have a cache of 1000s
-    // of items in any case (since that would likely take up a ton
-    // of memory, which we want to avoid since it's likely many
-    // crashes with the old index were due to too much memory
-    // usage)
-    //
-    // Linear searching a vector of at most a couple dozen items is
-    // lightning-fast (🚀), and besides the main performance benefit
-    // comes from the lack of a web request - not how many extra
-    // milliseconds we can squeeze out of a map access
-    std::vector<std::pair<K, V>> m_values;
-    size_t m_sizeLimit = 20;
+static std::atomic_size_t s_cacheHits = 0;
+static std::atomic_size_t s_cacheMisses = 0;
+static std::atomic_size_t s_cacheEvictions = 0;
+static std::atomic_size_t s_cacheRevalidations = 0;
 
-public:
-    std::optional<V> get(K const& key) {
-        auto it = std::find_if(m_values.begin(), m_values.end(), [key](auto const& q) {
-            return q.first == key;
-        });
-        if (it != m_values.end()) {
-            return it->second;
-        }
-        return std::nullopt;
+// Rough memory footprint of cached values, used for keeping the caches within
+// their byte budget. Only has to be in the right ballpark
+static constexpr size_t CACHE_ENTRY_OVERHEAD = 256;
+
+template <class T>
+static size_t estimateCacheSize(T const&) {
+    return sizeof(T);
+}
+template <class T>
+static size_t estimateCacheSize(std::vector<T> const& values) {
+    size_t size = 0;
+    for (auto const& value : values) {
+        size += estimateCacheSize(value);
     }
-    void add(K&& key, V&& value) {
-        auto pair = std::make_pair(std::move(key), std::move(value));
+    return size;
+}
+static size_t estimateCacheSize(ByteVector const& data) {
+    return data.size();
+}
+static size_t estimateCacheSize(ServerModVersion const& version) {
+    // ModMetadata holds a lot of strings that aren't worth walking through
+    return sizeof(ServerModVersion) + 2048 + version.downloadURL.size();
+}
+static size_t estimateCacheSize(ServerModMetadata const& mod) {
+    return sizeof(ServerModMetadata) +
+        estimateCacheSize(mod.versions) +
+        mod.developers.size() * sizeof(ServerDeveloper) +
+        mod.about.value_or("").size() +
+        mod.changelog.value_or("").size();
+}
+static size_t estimateCacheSize(ServerModsList const& list) {
+    return sizeof(ServerModsList) + estimateCacheSize(list.mods);
+}
 
-        // Shift and replace last element if we're at cache size limit
-        if (m_values.size() >= m_sizeLimit) {
-            std::shift_left(m_values.begin(), m_values.end(), 1);
-            m_values.back() = std::move(pair);
+struct ServerRequestSize final {
+    template <class T>
+    CacheEntrySize operator()(ServerRequest<T>& request) const {
+        if (auto value = request.getFinishedValue(); value && value->isOk()) {
+            return { CACHE_ENTRY_OVERHEAD + estimateCacheSize(value->unwrap()), true };
         }
-        // Otherwise append at end
-        else {
-            m_values.emplace_back(std::move(pair));
+        return { CACHE_ENTRY_OVERHEAD, !request.isPending() };
+    }
+};
+
+// Keeps server responses on disk between launches. Entries are revalidated
+// with the ETag or Last-Modified header the server sent with them, so on a
+// warm start the server only has to answer with a 304 instead of sending
+// everything again. Everything here touches the disk, so it's only used from
+// worker threads through getWithDiskCache
+class ServerDiskCache final {
+private:
+    static constexpr size_t SIZE_LIMIT = 64 * 1024 * 1024;
+
+    std::mutex m_mutex;
+    // Total size of the files in the cache, calculated on first store
+    std::optional<size_t> m_size;
+
+    static std::filesystem::path getDir() {
+        return dirs::getIndexDir() / "cache";
+    }
+    static std::filesystem::path getMetaPath(std::filesystem::path const& path) {
+        auto meta = path;
+        meta += ".meta";
+        return meta;
+    }
+    static size_t getEntrySize(std::filesystem::path const& path) {
+        size_t size = 0;
+        std::error_code ec;
+        for (auto const& file : { path, getMetaPath(path) }) {
+            auto fileSize = std::filesystem::file_size(file, ec);
+            if (!ec) size += fileSize;
         }
+        return size;
     }
-    void remove(K const& key) {
-        ranges::remove(m_values, [&key](auto const& q) { return q.first == key; });
+
+    // Must be called with m_mutex locked
+    size_t getSize() {
+        if (!m_size) {
+            m_size = 0;
+            std::error_code ec;
+            for (auto const& entry : std::filesystem::directory_iterator(getDir(), ec)) {
+                auto size = entry.file_size(ec);
+                if (!ec) *m_size += size;
+            }
+        }
+        return *m_size;
     }
-    void clear() {
-        m_values.clear();
+
+    // Must be called with m_mutex locked
+    void evict() {
+        std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> bodies;
+        std::error_code ec;
+        for (auto const& entry : std::filesystem::directory_iterator(getDir(), ec)) {
+            if (entry.path().extension() != ".meta") {
+                bodies.emplace_back(entry.last_write_time(ec), entry.path());
+            }
+        }
+        std::sort(bodies.begin(), bodies.end());
+
+        // Go down to three quarters of the limit so this doesn't have to run
+        // again on the very next store
+        for (auto const& [_, path] : bodies) {
+            if (*m_size <= SIZE_LIMIT / 4 * 3) break;
+            auto size = getEntrySize(path);
+            std::filesystem::remove(path, ec);
+            std::filesystem::remove(getMetaPath(path), ec);
+            *m_size -= std::min(*m_size, size);
+        }
     }
-    void limit(size_t size) {
-        m_sizeLimit = size;
-        m_values.clear();
+
+public:
+    static ServerDiskCache& get() {
+        static auto inst = new ServerDiskCache();
+        return *inst;
     }
-    size_t size() const {
-        return m_values.size();
+
+    /**
+     * Get the headers that make a request conditional on the cached entry
+     * having changed, if there is one
+     */
+    std::vector<std::pair<std::string, std::string>> getConditionalHeaders(std::string const& name) {
+        std::lock_guard lock(m_mutex);
+        std::vector<std::pair<std::string, std::string>> headers;
+        auto path = getDir() / name;
+        if (!std::filesystem::exists(path)) {
+            return headers;
+        }
+        auto meta = file::readJson(getMetaPath(path));
+        if (!meta) {
+            return headers;
+        }
+        if (auto etag = meta.unwrap()["etag"].asString()) {
+            headers.emplace_back("If-None-Match", etag.unwrap());
+        }
+        if (auto modified = meta.unwrap()["last-modified"].asString()) {
+            headers.emplace_back("If-Modified-Since", modified.unwrap());
+        }
+        return headers;
     }
-    size_t limit() const {
-        return m_sizeLimit;
+
+    /**
+     * Get the body of the response to a request made with the headers from
+     * `getConditionalHeaders`. On 304 Not Modified the body is read from
+     * disk; otherwise the body is stored if the server sent something to
+     * revalidate it with
+     * @returns The body, or nullopt if the request failed or the entry the
+     * server said was still valid has been evicted since
+     */
+    std::optional<ByteVector> resolve(std::string const& name, web::WebResponse const& response) {
+        std::lock_guard lock(m_mutex);
+        auto path = getDir() / name;
+
+        if (response.code() == 304) {
+            auto data = file::readBinary(path);
+            if (!data) {
+                return std::nullopt;
+            }
+            s_cacheRevalidations += 1;
+            // Keep recently used entries from being evicted
+            std::error_code ec;
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+            return std::move(data).unwrap();
+        }
+        if (!response.ok()) {
+            return std::nullopt;
+        }
+
+        auto data = response.data();
+        auto etag = response.header("ETag");
+        auto modified = response.header("Last-Modified");
+        if (!etag && !modified) {
+            // Don't keep revalidating an outdated entry
+            if (auto size = getEntrySize(path)) {
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+                std::filesystem::remove(getMetaPath(path), ec);
+                m_size = this->getSize() - std::min(this->getSize(), size);
+            }
+            return data;
+        }
+
+        auto meta = matjson::Value::object();
+        if (etag) meta["etag"] = *etag;
+        if (modified) meta["last-modified"] = *modified;
+
+        auto size = this->getSize() - std::min(this->getSize(), getEntrySize(path));
+        (void)file::createDirectoryAll(getDir());
+        (void)file::writeBinarySafe(path, data);
+        (void)file::writeStringSafe(getMetaPath(path), meta.dump(matjson::NO_INDENTATION));
+        m_size = size + getEntrySize(path);
+        if (*m_size > SIZE_LIMIT) {
+            this->evict();
+        }
+        return data;
     }
 };
 
+struct CachedResponse final {
+    web::WebResponse response;
+    // Empty if the request failed
+    std::optional<ByteVector> body;
+};
+using CachedWebTask = Task<CachedResponse, web::WebProgress>;
+
+static void sendWithDiskCache(
+    std::string url, std::string cacheName, bool conditional,
+    CachedWebTask::PostResult finish, CachedWebTask::PostProgress progress,
+    CachedWebTask::HasBeenCancelled hasBeenCancelled
+) {
+    utils::thread::Executor::getBlocking()->submit([=] {
+        auto headers = conditional ?
+            ServerDiskCache::get().getConditionalHeaders(cacheName) :
+            std::vector<std::pair<std::string, std::string>>();
+        queueInMainThread([=, headers = std::move(headers)] {
+            if (hasBeenCancelled()) {
+                finish(CachedWebTask::Cancel());
+                return;
+            }
+            auto req = web::WebRequest();
+            req.userAgent(getServerUserAgent());
+            for (auto const& [name, value] : headers) {
+                req.header(name, value);
+            }
+            auto task = req.get(url);
+            task.listen(
+                [=](web::WebResponse* value) {
+                    utils::thread::Executor::getBlocking()->submit([=, response = *value] {
+                        auto body = ServerDiskCache::get().resolve(cacheName, response);
+                        // The entry was evicted (or couldn't be read) after the
+                        // request was made conditional on it, so get it in full
+                        if (!body && response.code() == 304 && !headers.empty()) {
+                            sendWithDiskCache(url, cacheName, false, finish, progress, hasBeenCancelled);
+                            return;
+                        }
+                        finish(CachedResponse {
+                            .response = response,
+                            .body = std::move(body),
+                        });
+                    });
+                },
+                [=](web::WebProgress* value) mutable {
+                    if (hasBeenCancelled()) {
+                        task.cancel();
+                        return;
+                    }
+                    progress(*value);
+                },
+                [=] {
+                    finish(CachedWebTask::Cancel());
+                }
+            );
+        });
+    });
+}
+
+// Sends a GET request through the disk cache. The disk is only touched from
+// worker threads; the main thread just starts the request
+static CachedWebTask getWithDiskCache(std::string url, std::string cacheName) {
+    auto [task, finish, progress, hasBeenCancelled] = CachedWebTask::spawn(
+        fmt::format("Cached server request for {}", cacheName)
+    );
+    sendWithDiskCache(std::move(url), std::move(cacheName), true, finish, progress, hasBeenCancelled);
+    return task;
+}
+
 template <class F>
 struct ExtractFun;
 
@@ -111,7 +316,7 @@ public:
 
 private:
     std::mutex m_mutex;
-    CacheMap<CacheKey, ServerRequest<Value>> m_cache;
+    CacheMap<CacheKey, ServerRequest<Value>, ServerRequestSize> m_cache;
 
 public:
     FunCache() = default;
@@ -122,10 +327,12 @@ public:
     ServerRequest<Value> get(Args const&... args) {
         std::unique_lock lock(m_mutex);
         if (auto v = m_cache.get(Extract::key(args...))) {
+            s_cacheHits += 1;
             return *v;
         }
+        s_cacheMisses += 1;
         auto f = Extract::invoke(F, args...);
-        m_cache.add(Extract::key(args...), ServerRequest<Value>(f));
+        s_cacheEvictions += m_cache.add(Extract::key(args...), ServerRequest<Value>(f));
         return f;
     }
 
@@ -141,7 +348,7 @@ public:
     }
     void limit(size_t size) {
         std::unique_lock lock(m_mutex);
-        m_cache.limit(size);
+        s_cacheEvictions += m_cache.limit(size);
     }
     void clear() {
         std::unique_lock lock(m_mutex);
@@ -182,6 +389,21 @@ static Result<matjson::Value, ServerError> parseServerPayload(web::WebResponse c
     return Ok(json["payload"]);
 }
 
+static Result<matjson::Value, ServerError> parseServerPayload(int code, ByteVector const& body) {
+    auto asJson = matjson::parse(std::string_view(reinterpret_cast<char const*>(body.data()), body.size()));
+    if (!asJson) {
+        return Err(ServerError(code, "Response was not valid JSON: {}", asJson.unwrapErr()));
+    }
+    auto json = std::move(asJson).unwrap();
+    if (!json.isObject()) {
+        return Err(ServerError(code, "Expected object, got {}", jsonTypeToString(json.type())));
+    }
+    if (!json.contains("payload")) {
+        return Err(ServerError(code, "Object does not contain \"payload\" key - got {}", json.dump()));
+    }
+    return Ok(json["payload"]);
+}
+
 static ServerError parseServerError(web::WebResponse const& error) {
     // The server should return errors as `{ "error": "...", "payload": "" }`
     if (auto asJson = error.json()) {
@@ -635,24 +857,23 @@ ServerRequest<ServerModMetadata> server::getMod(std::string const& id, bool useC
     if (useCache) {
         return getCache<getMod>().get(id);
     }
-    auto req = web::WebRequest();
-    req.userAgent(getServerUserAgent());
-    return req.get(formatServerURL("/mods/{}", id)).map(
-        [](web::WebResponse* response) -> Result<ServerModMetadata, ServerError> {
-            if (response->ok()) {
+    return getWithDiskCache(formatServerURL("/mods/{}", id), fmt::format("mod-{}", id)).map(
+        [](CachedResponse* cached) -> Result<ServerModMetadata, ServerError> {
+            auto const& response = cached->response;
+            if (auto const& body = cached->body) {
                 // Parse payload
-                auto payload = parseServerPayload(*response);
+                auto payload = parseServerPayload(response.code(), *body);
                 if (!payload) {
                     return Err(payload.unwrapErr());
                 }
                 // Parse response
                 auto list = ServerModMetadata::parse(payload.unwrap());
                 if (!list) {
-                    return Err(ServerError(response->code(), "Unable to parse response: {}", list.unwrapErr()));
+                    return Err(ServerError(response.code(), "Unable to parse response: {}", list.unwrapErr()));
                 }
                 return Ok(list.unwrap());
             }
-            return Err(parseServerError(*response));
+            return Err(parseServerError(response));
         },
         [id](web::WebProgress* progress) {
             return parseServerProgress(*progress, "Downloading metadata for " + id);
@@ -719,14 +940,12 @@ ServerRequest<ByteVector> server::getModLogo(std::string const& id, bool useCach
     if (useCache) {
         return getCache<getModLogo>().get(id);
     }
-    auto req = web::WebRequest();
-    req.userAgent(getServerUserAgent());
-    return req.get(formatServerURL("/mods/{}/logo", id)).map(
-        [](web::WebResponse* response) -> Result<ByteVector, ServerError> {
-            if (response->ok()) {
-                return Ok(response->data());
+    return getWithDiskCache(formatServerURL("/mods/{}/logo", id), fmt::format("logo-{}", id)).map(
+        [](CachedResponse* cached) -> Result<ByteVector, ServerError> {
+            if (cached->body) {
+                return Ok(*cached->body);
             }
-            return Err(parseServerError(*response));
+            return Err(parseServerError(cached->response));
         },
         [id](web::WebProgress* progress) {
             return parseServerProgress(*progress, "Downloading logo for " + id);
@@ -738,23 +957,22 @@ ServerRequest<std::vector<ServerTag>> server::getTags(bool useCache) {
     if (useCache) {
         return getCache<getTags>().get();
     }
-    auto req = web::WebRequest();
-    req.userAgent(getServerUserAgent());
-    return req.get(formatServerURL("/detailed-tags")).map(
-        [](web::WebResponse* response) -> Result<std::vector<ServerTag>, ServerError> {
-            if (response->ok()) {
+    return getWithDiskCache(formatServerURL("/detailed-tags"), "tags").map(
+        [](CachedResponse* cached) -> Result<std::vector<ServerTag>, ServerError> {
+            auto const& response = cached->response;
+            if (auto const& body = cached->body) {
                 // Parse payload
-                auto payload = parseServerPayload(*response);
+                auto payload = parseServerPayload(response.code(), *body);
                 if (!payload) {
                     return Err(payload.unwrapErr());
                 }
                 auto list = ServerTag::parseList(payload.unwrap());
                 if (!list) {
-                    return Err(ServerError(response->code(), "Unable to parse response: {}", list.unwrapErr()));
+                    return Err(ServerError(response.code(), "Unable to parse response: {}", list.unwrapErr()));
                 }
                 return Ok(list.unwrap());
             }
-            return Err(parseServerError(*response));
+            return Err(parseServerError(response));
         },
         [](web::WebProgress* progress) {
             return parseServerProgress(*progress, "Downloading valid tags");
@@ -902,12 +1120,25 @@ void server::clearServerCaches(bool clearGlobalCaches) {
     }
 }
 
+ServerCacheStats server::getServerCacheStats() {
+    return ServerCacheStats {
+        .hits = s_cacheHits,
+        .misses = s_cacheMisses,
+        .evictions = s_cacheEvictions,
+        .revalidations = s_cacheRevalidations,
+    };
+}
+
+static void limitServerCaches(int64_t megabytes) {
+    auto size = static_cast<size_t>(megabytes) * 1024 * 1024;
+    getCache<&server::getMods>().limit(size);
+    getCache<&server::getMod>().limit(size);
+    getCache<&server::getModLogo>().limit(size);
+    getCache<&server::getTags>().limit(size);
+    getCache<&server::checkAllUpdates>().limit(size);
+}
+
 $on_mod(Loaded) {
-    listenForSettingChanges<int64_t>("server-cache-size-limit", +[](int64_t size) {
-        getCache<&server::getMods>().limit(size);
-        getCache<&server::getMod>().limit(size);
-        getCache<&server::getModLogo>().limit(size);
-        getCache<&server::getTags>().limit(size);
-        getCache<&server::checkAllUpdates>().limit(size);
-    });
+    limitServerCaches(Mod::get()->getSettingValue<int64_t>("server-cache-size-limit"));
+    listenForSettingChanges<int64_t>("server-cache-size-limit", &limitServerCaches);
 }
@@ -180,4 +180,17 @@ namespace server {
     ServerRequest<std::vector<ServerModUpdate>> checkAllUpdates(bool useCache = true);
 
     void clearServerCaches(bool clearGlobalCaches = false);
+
+    struct ServerCacheStats final {
+        // Requests served from the in-memory caches
+        size_t hits;
+        size_t misses;
+        // Items dropped from the in-memory caches to stay within their limit
+        size_t evictions;
+        // Requests the server answered with 304 Not Modified, so the response
+        // was read from the on-disk cache
+        size_t revalidations;
+    };
+
+    ServerCacheStats getServerCacheStats();
 }
@@ -0,0 +1,89 @@
+#include "MDBlocks.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+using namespace geode;
+
+static bool isBlank(std::string_view line) {
+    return line.find_first_not_of(" \t\r") == std::string_view::npos;
+}
+
+static bool isListItem(std::string_view line) {
+    if (line.empty()) return false;
+    if (line[0] == '-' || line[0] == '*' || line[0] == '+') {
+        return line.size() == 1 || line[1] == ' ' || line[1] == '\t';
+    }
+    size_t digits = 0;
+    while (digits < line.size() && digits < 10 && std::isdigit(static_cast<unsigned char>(line[digits]))) {
+        digits++;
+    }
+    if (digits == 0 || digits == line.size() || (line[digits] != '.' && line[digits] != ')')) {
+        return false;
+    }
+    return digits + 1 == line.size() || line[digits + 1] == ' ' || line[digits + 1] == '\t';
+}
+
+std::vector<std::string> geode::splitMarkdownBlocks(std::string_view text) {
+    std::vector<std::string> blocks;
+    std::string current;
+    // The opening fence of the code block currently in, like "```"
+    std::string fence;
+    bool afterBlank = false;
+
+    size_t start = 0;
+    while (start < text.size()) {
+        auto end = text.find('\n', start);
+        if (end == std::string_view::npos) end = text.size();
+        auto line = text.substr(start, end - start);
+        start = end + 1;
+
+        size_t pos = 0;
+        size_t indent = 0;
+        while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t')) {
+            indent += line[pos] == '\t' ? 4 - indent % 4 : 1;
+            pos++;
+        }
+        auto trimmed = line.substr(pos);
+
+        auto fenceLength = [&](char c) {
+            size_t len = 0;
+            while (len < trimmed.size() && trimmed[len] == c) len++;
+            return len >= 3 ? len : 0;
+        };
+
+        if (!fence.empty()) {
+            auto len = indent < 4 ? fenceLength(fence[0]) : 0;
+            if (len >= fence.size() && isBlank(trimmed.substr(len))) {
+                fence.clear();
+            }
+        }
+        else if (isBlank(line)) {
+            afterBlank = true;
+        }
+        else {
+            if (afterBlank && indent == 0 && !isListItem(trimmed) && !current.empty()) {
+                blocks.push_back(std::move(current));
+                current.clear();
+            }
+            afterBlank = false;
+
+            if (indent < 4) {
+                if (auto len = std::max(fenceLength('`'), fenceLength('~'))) {
+                    fence = std::string(trimmed.substr(0, len));
+                }
+                // Link reference definitions apply to the whole document
+                else if (trimmed.starts_with('[') && trimmed.find("]:") != std::string_view::npos) {
+                    return {};
+                }
+            }
+        }
+
+        current.append(line);
+        current.push_back('\n');
+    }
+    if (!current.empty()) {
+        blocks.push_back(std::move(current));
+    }
+    return blocks;
+}
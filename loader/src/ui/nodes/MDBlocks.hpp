@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace geode {
+    /**
+     * Split a document at the blank lines between its top-level blocks.
+     * Lists and fenced code blocks are kept whole, as are blocks indented
+     * under the one before them
+     * @returns The blocks, or an empty vector if the document can't be
+     * rendered block by block
+     */
+    std::vector<std::string> splitMarkdownBlocks(std::string_view text);
+}
@@ -18,6 +18,7 @@
 #include <Geode/loader/Log.hpp>
 #include <Geode/ui/GeodeUI.hpp>
 #include <server/Server.hpp>
+#include "MDBlocks.hpp"
 #include <regex>
 
 using namespace geode::prelude;
@@ -27,6 +28,9 @@ static constexpr float g_paragraphPadding = 7.f;
 static constexpr float g_indent = 7.f;
 static constexpr float g_codeBlockIndent = 8.f;
 static constexpr ccColor3B g_linkColor = {0x7f, 0xf4, 0xf4};
+// Documents at least this long only get nodes for the blocks near the
+// visible part of the text area
+static constexpr size_t g_virtualizeMinSize = 16 * 1024;
 
 TextRenderer::Font g_mdFont = [](int style) -> TextRenderer::Label {
     if ((style & TextStyleBold) && (style & TextStyleItalic)) {
@@ -228,6 +232,7 @@ struct MDParser {
     static size_t s_orderedListNum;
     static std::vector<TextRenderer::Label> s_codeSpans;
     static bool s_breakListLine;
+    static CCNode* s_content;
 
     static int parseText(MD_TEXTTYPE type, MD_CHAR const* rawText, MD_SIZE size, void* mdtextarea) {
         auto textarea = static_cast<MDTextArea*>(mdtextarea);
@@ -574,7 +579,7 @@ struct MDParser {
                     );
                     bg->setAnchorPoint({ .5f, .5f });
                     bg->setZOrder(-1);
-                    textarea->m_content->addChild(bg);
+                    s_content->addChild(bg);
 
                     renderer->popWrapOffset();
                     renderer->popIndent();
@@ -716,6 +721,75 @@ struct MDParser {
         }
         return 0;
     }
+
+    /**
+     * Render markdown onto a node
+     * @returns The height of what was rendered, including the padding after
+     * the last block
+     */
+    static float render(
+        MDTextArea* textarea, std::string const& text, CCNode* target, CCSize const& size,
+        bool fitToContent
+    ) {
+        auto renderer = textarea->m_renderer;
+        renderer->begin(target, CCPointZero, size);
+
+        renderer->pushFont(g_mdFont);
+        renderer->pushScale(.5f);
+        renderer->pushVerticalAlign(TextAlignment::End);
+        renderer->pushHorizontalAlign(TextAlignment::Begin);
+
+        MD_PARSER parser;
+
+        parser.abi_version = 0;
+        parser.flags = MD_FLAG_UNDERLINE | MD_FLAG_STRIKETHROUGH | MD_FLAG_PERMISSIVEURLAUTOLINKS |
+            MD_FLAG_PERMISSIVEWWWAUTOLINKS;
+
+        parser.text = &MDParser::parseText;
+        parser.enter_block = &MDParser::enterBlock;
+        parser.leave_block = &MDParser::leaveBlock;
+        parser.enter_span = &MDParser::enterSpan;
+        parser.leave_span = &MDParser::leaveSpan;
+        parser.debug_log = nullptr;
+        parser.syntax = nullptr;
+
+        s_codeSpans = {};
+        s_content = target;
+
+        if (md_parse(text.c_str(), text.size(), &parser, textarea)) {
+            renderer->renderString("Error parsing Markdown");
+        }
+
+        for (auto& render : s_codeSpans) {
+            auto bg = CCScale9Sprite::create("square02b_001.png", { 0.0f, 0.0f, 80.0f, 80.0f });
+            bg->setScale(.125f);
+            bg->setColor({ 0, 0, 0 });
+            bg->setOpacity(75);
+            bg->setContentSize(render.m_node->getScaledContentSize() * 8 + CCSize { 20.f, .0f });
+            bg->setPosition(
+                render.m_node->getPositionX() - 2.5f * (.5f - render.m_node->getAnchorPoint().x),
+                render.m_node->getPositionY() - .5f
+            );
+            bg->setAnchorPoint(render.m_node->getAnchorPoint());
+            bg->setZOrder(-1);
+            target->addChild(bg);
+            // i know what you're thinking.
+            // my brother in christ, what the hell is this?
+            // where did this magical + 1.5f come from?
+            // the reason is that if you remove them, code
+            // spans are slightly offset and it triggers my
+            // OCD.
+            render.m_node->setPositionY(render.m_node->getPositionY() + 1.5f);
+        }
+        s_codeSpans = {};
+        s_content = nullptr;
+
+        auto cursorY = renderer->getCursorPos().y;
+        renderer->end(fitToContent);
+
+        auto coverage = calculateChildCoverage(target);
+        return std::max(-cursorY, -coverage.origin.y);
+    }
 };
 
 std::string MDParser::s_lastLink = "";
@@ -726,31 +800,202 @@ bool MDParser::s_isCodeBlock = false;
 float MDParser::s_codeStart = 0;
 decltype(MDParser::s_codeSpans) MDParser::s_codeSpans = {};
 bool MDParser::s_breakListLine = false;
+CCNode* MDParser::s_content = nullptr;
+
+// Lays out long documents block by block. The document is split into its
+// top-level blocks, and only the blocks near the visible part of the scroll
+// layer are rendered; the rest are released again once they're scrolled far
+// enough away. Blocks that haven't been rendered yet use an estimated height,
+// which is corrected the first time they are
+class MDVirtualLayout : public CCNode {
+protected:
+    struct Block {
+        std::string text;
+        // Distance from the top of the document
+        float top = 0.f;
+        float height = 0.f;
+        // Rendered nodes and their Y position relative to the top of the block
+        std::vector<std::pair<Ref<CCNode>, float>> nodes;
+    };
+
+    // Not retained, as the text area owns this node
+    MDTextArea* m_textarea = nullptr;
+    std::vector<Block> m_blocks;
+    float m_height = 0.f;
+    float m_lineHeight = 0.f;
+    float m_charWidth = 0.f;
+    std::optional<float> m_lastScrollY;
+
+    float estimateHeight(std::string_view text) const {
+        auto width = std::max(m_textarea->m_size.width, 1.f);
+        size_t lines = 0;
+        for (auto line : utils::string::split(std::string(text), "\n")) {
+            lines += std::max<size_t>(1, static_cast<size_t>(std::ceil(line.size() * m_charWidth / width)));
+        }
+        return lines * m_lineHeight + g_paragraphPadding;
+    }
 
-void MDTextArea::updateLabel() {
-    m_renderer->begin(m_content, CCPointZero, m_size);
+    float getContentHeight() const {
+        return std::max(m_height, m_textarea->m_size.height);
+    }
+
+    void updateSizes() {
+        auto content = m_textarea->m_content;
+        auto contentLayer = m_textarea->m_scrollLayer->m_contentLayer;
+        content->setContentSize({ m_textarea->m_size.width, this->getContentHeight() });
+        if (content->getContentSize().height > m_textarea->m_size.height) {
+            // Generate bottom padding
+            contentLayer->setContentSize(content->getContentSize() + CCSize { 0.f, 12.5 });
+            content->setPositionY(10.f);
+        } else {
+            contentLayer->setContentSize(content->getContentSize());
+            content->setPositionY(-2.5f);
+        }
+    }
+
+    void positionNodes(Block const& block) {
+        auto top = this->getContentHeight() - block.top;
+        for (auto const& [node, y] : block.nodes) {
+            node->setPositionY(top + y);
+        }
+    }
+
+    void renderBlock(Block& block) {
+        auto target = CCNode::create();
+        block.height = MDParser::render(
+            m_textarea, block.text, target, { m_textarea->m_size.width, 0.f }, false
+        );
+        for (auto child : CCArrayExt<CCNode*>(target->getChildren())) {
+            block.nodes.emplace_back(child, child->getPositionY());
+        }
+        target->removeAllChildrenWithCleanup(false);
+        for (auto const& [node, _] : block.nodes) {
+            m_textarea->m_content->addChild(node);
+        }
+    }
+
+    void releaseBlock(Block& block) {
+        for (auto const& [node, _] : block.nodes) {
+            node->removeFromParent();
+        }
+        block.nodes.clear();
+    }
+
+    void updateVisible() {
+        auto scrollLayer = m_textarea->m_scrollLayer;
+        auto contentLayer = scrollLayer->m_contentLayer;
+        auto viewHeight = scrollLayer->getContentSize().height;
+        auto scrollY = contentLayer->getPositionY();
+
+        // Part of the document at the top of the view, plus a view's height of
+        // margin on both sides so short scrolls don't need to render anything
+        auto viewTop = this->getContentHeight() + scrollY +
+            m_textarea->m_content->getPositionY() - viewHeight;
+        auto from = viewTop - viewHeight;
+        auto to = viewTop + viewHeight * 2;
+
+        for (auto& block : m_blocks) {
+            if (!block.nodes.empty() && (block.top + block.height < from || block.top > to)) {
+                this->releaseBlock(block);
+            }
+        }
+
+        // Corrected heights move every block after them
+        float shift = 0.f;
+        // How much of that is above the view
+        float shiftAbove = 0.f;
+        bool rendered = false;
+        for (auto& block : m_blocks) {
+            block.top += shift;
+            if (!block.nodes.empty() || block.top + block.height < from || block.top > to) {
+                continue;
+            }
+            auto estimate = block.height;
+            this->renderBlock(block);
+            rendered = true;
+
+            auto diff = block.height - estimate;
+            shift += diff;
+            if (block.top + estimate <= viewTop) {
+                shiftAbove += diff;
+                viewTop += diff;
+                from += diff;
+                to += diff;
+            }
+        }
 
-    m_renderer->pushFont(g_mdFont);
-    m_renderer->pushScale(.5f);
-    m_renderer->pushVerticalAlign(TextAlignment::End);
-    m_renderer->pushHorizontalAlign(TextAlignment::Begin);
+        if (shift != 0.f) {
+            m_height += shift;
+            this->updateSizes();
+            // Keep what was being looked at in place
+            auto minScrollY = viewHeight - contentLayer->getContentSize().height;
+            scrollY = std::clamp(scrollY + shiftAbove - shift, std::min(minScrollY, 0.f), 0.f);
+            contentLayer->setPositionY(scrollY);
+        }
+        if (rendered) {
+            for (auto const& block : m_blocks) {
+                this->positionNodes(block);
+            }
+        }
+        m_lastScrollY = scrollY;
+    }
+
+public:
+    static MDVirtualLayout* create(MDTextArea* textarea) {
+        auto ret = new MDVirtualLayout();
+        if (ret->init()) {
+            ret->m_textarea = textarea;
+            ret->scheduleUpdate();
+            ret->autorelease();
+            return ret;
+        }
+        delete ret;
+        return nullptr;
+    }
 
-    MD_PARSER parser;
+    void setBlocks(std::vector<std::string>&& texts) {
+        this->clear();
+
+        m_lineHeight = FNTConfigLoadFile("mdFont.fnt"_spr)->m_nCommonHeight /
+            CC_CONTENT_SCALE_FACTOR() * g_fontScale;
+        std::string_view sample = "The quick brown fox jumps over the lazy dog";
+        m_charWidth = getLabelSize(sample, "mdFont.fnt"_spr).width * g_fontScale / sample.size();
+
+        m_height = 0.f;
+        for (auto& text : texts) {
+            auto height = this->estimateHeight(text);
+            m_blocks.push_back(Block {
+                .text = std::move(text),
+                .top = m_height,
+                .height = height,
+            });
+            m_height += height;
+        }
 
-    parser.abi_version = 0;
-    parser.flags = MD_FLAG_UNDERLINE | MD_FLAG_STRIKETHROUGH | MD_FLAG_PERMISSIVEURLAUTOLINKS |
-        MD_FLAG_PERMISSIVEWWWAUTOLINKS;
+        this->updateSizes();
+        m_textarea->m_scrollLayer->moveToTop();
+        this->updateVisible();
+    }
 
-    parser.text = &MDParser::parseText;
-    parser.enter_block = &MDParser::enterBlock;
-    parser.leave_block = &MDParser::leaveBlock;
-    parser.enter_span = &MDParser::enterSpan;
-    parser.leave_span = &MDParser::leaveSpan;
-    parser.debug_log = nullptr;
-    parser.syntax = nullptr;
+    void clear() {
+        for (auto& block : m_blocks) {
+            this->releaseBlock(block);
+        }
+        m_blocks.clear();
+        m_height = 0.f;
+        m_lastScrollY = std::nullopt;
+    }
 
-    MDParser::s_codeSpans = {};
+    void update(float) override {
+        if (m_blocks.empty()) return;
+        auto scrollY = m_textarea->m_scrollLayer->m_contentLayer->getPositionY();
+        if (scrollY != m_lastScrollY) {
+            this->updateVisible();
+        }
+    }
+};
 
+void MDTextArea::updateLabel() {
     auto textContent = m_text;
     if (auto boolObj = static_cast<CCBool*>(this->getUserObject("compatibilityMode"_spr))) {
         if (boolObj->getValue()) {
@@ -761,33 +1006,25 @@ void MDTextArea::updateLabel() {
         }
     }
 
-    if (md_parse(textContent.c_str(), textContent.size(), &parser, this)) {
-        m_renderer->renderString("Error parsing Markdown");
+    auto layout = static_cast<MDVirtualLayout*>(this->getUserObject("virtual-layout"_spr));
+    if (layout) {
+        layout->clear();
+    }
+    if (textContent.size() >= g_virtualizeMinSize) {
+        auto blocks = splitMarkdownBlocks(textContent);
+        if (blocks.size() > 1) {
+            if (!layout) {
+                layout = MDVirtualLayout::create(this);
+                this->setUserObject("virtual-layout"_spr, layout);
+                this->addChild(layout);
+            }
+            m_content->removeAllChildren();
+            layout->setBlocks(std::move(blocks));
+            return;
+        }
     }
 
-    for (auto& render : MDParser::s_codeSpans) {
-        auto bg = CCScale9Sprite::create("square02b_001.png", { 0.0f, 0.0f, 80.0f, 80.0f });
-        bg->setScale(.125f);
-        bg->setColor({ 0, 0, 0 });
-        bg->setOpacity(75);
-        bg->setContentSize(render.m_node->getScaledContentSize() * 8 + CCSize { 20.f, .0f });
-        bg->setPosition(
-            render.m_node->getPositionX() - 2.5f * (.5f - render.m_node->getAnchorPoint().x),
-            render.m_node->getPositionY() - .5f
-        );
-        bg->setAnchorPoint(render.m_node->getAnchorPoint());
-        bg->setZOrder(-1);
-        m_content->addChild(bg);
-        // i know what you're thinking.
-        // my brother in christ, what the hell is this?
-        // where did this magical + 1.5f come from?
-        // the reason is that if you remove them, code
-        // spans are slightly offset and it triggers my
-        // OCD.
-        render.m_node->setPositionY(render.m_node->getPositionY() + 1.5f);
-    }
-
-    m_renderer->end();
+    MDParser::render(this, textContent, m_content, m_size, true);
 
     if (m_content->getContentSize().height > m_size.height) {
         // Generate bottom padding
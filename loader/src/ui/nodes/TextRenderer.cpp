@@ -345,11 +345,22 @@ std::vector<TextRenderer::Label> TextRenderer::renderStringEx(
         m_cursor.x = this->getCurrentIndent();
     }
 
+    // bmfont labels are wrapped by measuring the text from the font's glyph
+    // and kerning tables, so their string only gets set (and their sprites
+    // rebuilt) once per line. other labels are measured by setting the
+    // string and rolling it back if it doesn't fit
+    CCLabelBMFont* bmFont = nullptr;
+    // scale from the bmfont label to the label node being positioned
+    float bmFontScale = 1.f;
+    std::string lineText;
+    bool lineTextChanged = false;
+
     auto createLabel = [&]() -> bool {
         // create label through font and add
         // decorations (underline, strikethrough) +
         // buttonize (new word just dropped)
-        label = this->addWrappers(font(style), isButton, target, callback);
+        auto base = font(style);
+        label = this->addWrappers(base, isButton, target, callback);
 
         label.m_node->setScale(scale);
         label.m_node->setPosition(m_cursor);
@@ -363,10 +374,55 @@ std::vector<TextRenderer::Label> TextRenderer::renderStringEx(
             m_target->addChild(label.m_node);
         }
 
+        bmFont = typeinfo_cast<CCLabelBMFont*>(base.m_node);
+        if (bmFont) {
+            bmFontScale = 1.f;
+            for (CCNode* node = bmFont; node; node = node->getParent()) {
+                bmFontScale *= node->getScaleX();
+                if (node == label.m_node) break;
+            }
+            auto str = bmFont->getString();
+            lineText = str ? str : "";
+            lineTextChanged = false;
+        }
+
+        return true;
+    };
+
+    // give the current label its final string
+    auto flushLine = [&]() {
+        if (bmFont && lineTextChanged) {
+            label.m_labelProtocol->setString(lineText.c_str());
+            lineTextChanged = false;
+        }
+    };
+
+    // add text to the end of the current line if it fits, or regardless if
+    // forced
+    auto append = [&](std::string const& text, bool force) -> bool {
+        if (!bmFont) {
+            if (this->render(text, label.m_node, label.m_labelProtocol)) return true;
+            if (!force) return false;
+            auto str = label.m_labelProtocol->getString();
+            label.m_labelProtocol->setString(((str ? str : ""s) + text).c_str());
+            return true;
+        }
+        auto str = lineText + text;
+        if (m_size.width && !force) {
+            auto width = cocos::getLabelSize(
+                str, bmFont->getFntFile(), bmFont->getExtraKerning()
+            ).width * bmFontScale;
+            if (m_cursor.x + width > m_size.width - this->getCurrentWrapOffset()) {
+                return false;
+            }
+        }
+        lineText = std::move(str);
+        lineTextChanged = true;
         return true;
     };
 
     auto nextLine = [&]() -> bool {
+        flushLine();
         this->breakLine(label.m_lineHeight * scale);
         if (!createLabel()) return false;
         newLine = true;
@@ -396,7 +452,7 @@ std::vector<TextRenderer::Label> TextRenderer::renderStringEx(
             }
 
             // try to render at the end of current line
-            if (this->render(word, label.m_node, label.m_labelProtocol)) continue;
+            if (append(word, false)) continue;
 
             // try to create a new line
             if (!nextLine()) return {};
@@ -405,22 +461,28 @@ std::vector<TextRenderer::Label> TextRenderer::renderStringEx(
             newLine = false;
 
             // try to render on new line
-            if (this->render(word, label.m_node, label.m_labelProtocol)) continue;
+            if (append(word, false)) continue;
 
             // no need to create a new line as we know
             // the current one has no content and is
             // supposed to receive this one
 
-            // render character by character
-            for (auto& c : word) {
-                if (!this->render(std::string(1, c), label.m_node, label.m_labelProtocol)) {
-                    if (!nextLine()) return {};
-
-                    if (utils::string::startsWith(word, " ")) word = word.substr(1);
-                    newLine = false;
-                }
+            // render character by character, keeping utf-8 sequences together
+            for (size_t i = 0; i < word.size();) {
+                size_t len = 1;
+                while (i + len < word.size() && (word[i + len] & 0xc0) == 0x80) len++;
+                auto c = word.substr(i, len);
+                i += len;
+
+                if (append(c, false)) continue;
+                if (!nextLine()) return {};
+                newLine = false;
+                // a character that doesn't fit on an empty line
+                // still has to go somewhere
+                append(c, true);
             }
         }
+        flushLine();
         // increment cursor position
         m_cursor.x += label.m_node->getScaledContentSize().width;
     }
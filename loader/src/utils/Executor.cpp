@@ -0,0 +1,318 @@
+#include <Geode/utils/Executor.hpp>
+#include <Geode/utils/general.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace geode::prelude;
+using namespace geode::utils::thread;
+
+// How long workers above the core count stay alive without any jobs
+static constexpr auto EXTRA_WORKER_IDLE_TIMEOUT = std::chrono::seconds(10);
+// How long queued jobs may go without any of them starting while every
+// worker is busy before an executor that can grow past its limit does so
+static constexpr auto STARVATION_TIMEOUT = std::chrono::milliseconds(250);
+
+class Executor::Impl final : public std::enable_shared_from_this<Impl> {
+public:
+    struct QueuedJob {
+        Job job;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+    struct Worker {
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+
+    std::string m_name;
+    size_t m_maxWorkers;
+    // Whether m_maxWorkers may be exceeded when every worker is blocked
+    bool m_growWhenStarved;
+    // Queues of the core workers; never changes after start() so other
+    // workers can steal from them without locking the list itself
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_coreThreads;
+
+    // Protects m_jobs, m_alive and m_stopping
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    // Jobs submitted from outside the executor's own workers
+    std::deque<QueuedJob> m_jobs;
+    size_t m_alive = 0;
+    bool m_stopping = false;
+    // Wakes the watchdog once a job couldn't get a worker due to the limit
+    std::condition_variable m_starvedCv;
+    std::thread m_watchdog;
+
+    std::atomic_size_t m_pending = 0;
+    std::atomic_size_t m_active = 0;
+    std::atomic_size_t m_started = 0;
+    std::atomic_size_t m_completed = 0;
+    std::atomic_size_t m_threadCounter = 0;
+    std::atomic<int64_t> m_totalLatency = 0;
+    std::atomic<int64_t> m_maxLatency = 0;
+
+    static thread_local Impl* s_currentImpl;
+    static thread_local Worker* s_currentWorker;
+
+    Impl(std::string name, size_t coreWorkers, size_t maxWorkers, bool growWhenStarved)
+      : m_name(std::move(name)),
+        m_maxWorkers(maxWorkers == 0 ? 0 : std::max(coreWorkers, maxWorkers)),
+        m_growWhenStarved(growWhenStarved && maxWorkers != 0)
+    {
+        for (size_t i = 0; i < coreWorkers; i++) {
+            m_workers.push_back(std::make_unique<Worker>());
+        }
+    }
+
+    void start() {
+        std::unique_lock lock(m_mutex);
+        for (auto& worker : m_workers) {
+            m_alive += 1;
+            m_coreThreads.emplace_back([self = shared_from_this(), worker = worker.get()] {
+                self->work(worker);
+            });
+        }
+        if (m_growWhenStarved) {
+            m_watchdog = std::thread([self = shared_from_this()] {
+                self->watch();
+            });
+        }
+    }
+
+    void stop() {
+        {
+            std::unique_lock lock(m_mutex);
+            m_stopping = true;
+        }
+        m_cv.notify_all();
+        m_starvedCv.notify_all();
+        if (m_watchdog.joinable()) {
+            m_watchdog.join();
+        }
+        for (auto& thread : m_coreThreads) {
+            // an executor destroyed from one of its own jobs can't wait
+            // for itself to finish
+            if (thread.get_id() == std::this_thread::get_id()) {
+                thread.detach();
+            }
+            else {
+                thread.join();
+            }
+        }
+        m_coreThreads.clear();
+    }
+
+    void submit(Job&& job) {
+        QueuedJob queued { std::move(job), std::chrono::steady_clock::now() };
+        // incremented before the job is queued so that a worker can never
+        // take it before it is counted
+        m_pending += 1;
+        if (s_currentImpl == this && s_currentWorker) {
+            std::unique_lock lock(s_currentWorker->mutex);
+            s_currentWorker->jobs.push_back(std::move(queued));
+        }
+        else {
+            std::unique_lock lock(m_mutex);
+            m_jobs.push_back(std::move(queued));
+        }
+
+        bool spawn = false;
+        {
+            std::unique_lock lock(m_mutex);
+            // only start an extra worker once the backlog is larger than
+            // what the idle and core workers can reasonably get through
+            auto idle = m_alive - std::min(m_alive, m_active.load());
+            auto backlog = idle + m_workers.size();
+            auto atLimit = m_maxWorkers != 0 && m_alive >= m_maxWorkers;
+            if (m_pending > backlog && !atLimit && !m_stopping) {
+                m_alive += 1;
+                spawn = true;
+            }
+            else if (atLimit && m_growWhenStarved) {
+                m_starvedCv.notify_one();
+            }
+        }
+        if (spawn) {
+            this->spawnExtraWorker();
+        }
+        else {
+            m_cv.notify_one();
+        }
+    }
+
+    // Expects m_alive to already have been incremented
+    void spawnExtraWorker() {
+        std::thread([self = shared_from_this()] {
+            self->work(nullptr);
+        }).detach();
+    }
+
+    // If every worker is stuck in a job that waits for another job that is
+    // still queued, nothing would ever make progress again. Once no job has
+    // started for a while despite jobs being queued, start more workers
+    // regardless of the limit; they exit again once they have been idle
+    void watch() {
+        utils::thread::setName(fmt::format("{} Watchdog", m_name));
+        std::unique_lock lock(m_mutex);
+        while (!m_stopping) {
+            // submit() wakes us up once it runs into the limit; after that,
+            // keep checking for as long as there are jobs queued
+            if (m_pending == 0) {
+                m_starvedCv.wait(lock);
+                continue;
+            }
+            auto started = m_started.load();
+            m_starvedCv.wait_for(lock, STARVATION_TIMEOUT, [this] { return m_stopping; });
+            auto starved = m_pending > 0 && m_active.load() >= m_alive;
+            if (!m_stopping && starved && m_started.load() == started) {
+                auto count = std::clamp<size_t>(m_pending, 1, std::max<size_t>(m_workers.size(), 1));
+                for (size_t i = 0; i < count; i++) {
+                    m_alive += 1;
+                    this->spawnExtraWorker();
+                }
+            }
+        }
+    }
+
+    std::optional<QueuedJob> take(Worker* self) {
+        std::optional<QueuedJob> ret;
+        // own queue first, newest job first since it's the most likely to
+        // still be in cache
+        if (self) {
+            std::unique_lock lock(self->mutex);
+            if (!self->jobs.empty()) {
+                ret = std::move(self->jobs.back());
+                self->jobs.pop_back();
+            }
+        }
+        if (!ret) {
+            std::unique_lock lock(m_mutex);
+            if (!m_jobs.empty()) {
+                ret = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+        }
+        if (!ret) {
+            for (auto& other : m_workers) {
+                if (other.get() == self) continue;
+                std::unique_lock lock(other->mutex);
+                if (!other->jobs.empty()) {
+                    ret = std::move(other->jobs.front());
+                    other->jobs.pop_front();
+                    break;
+                }
+            }
+        }
+        if (ret) {
+            m_pending -= 1;
+        }
+        return ret;
+    }
+
+    void run(QueuedJob&& queued) {
+        auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - queued.queuedAt
+        ).count();
+        m_totalLatency += latency;
+        auto max = m_maxLatency.load();
+        while (latency > max && !m_maxLatency.compare_exchange_weak(max, latency)) {}
+        m_started += 1;
+
+        m_active += 1;
+        queued.job();
+        m_active -= 1;
+        m_completed += 1;
+    }
+
+    void work(Worker* self) {
+        s_currentImpl = this;
+        s_currentWorker = self;
+        utils::thread::setName(fmt::format("{} #{}", m_name, ++m_threadCounter));
+
+        while (true) {
+            if (auto queued = this->take(self)) {
+                this->run(std::move(*queued));
+                continue;
+            }
+            std::unique_lock lock(m_mutex);
+            auto hasWork = [this] { return m_pending > 0 || m_stopping; };
+            if (self) {
+                m_cv.wait(lock, hasWork);
+            }
+            // workers above the core count exit after being idle for a while
+            else if (!m_cv.wait_for(lock, EXTRA_WORKER_IDLE_TIMEOUT, hasWork)) {
+                m_alive -= 1;
+                return;
+            }
+            // finish whatever is still queued before exiting
+            if (m_stopping && m_pending == 0) {
+                m_alive -= 1;
+                return;
+            }
+        }
+    }
+};
+
+thread_local Executor::Impl* Executor::Impl::s_currentImpl = nullptr;
+thread_local Executor::Impl::Worker* Executor::Impl::s_currentWorker = nullptr;
+
+Executor::Executor(std::string name, size_t coreWorkers, size_t maxWorkers, bool growWhenStarved)
+  : m_impl(std::make_shared<Impl>(std::move(name), coreWorkers, maxWorkers, growWhenStarved))
+{
+    m_impl->start();
+}
+
+Executor::~Executor() {
+    m_impl->stop();
+}
+
+std::unique_ptr<Executor> Executor::create(std::string name, size_t coreWorkers, size_t maxWorkers) {
+    return std::unique_ptr<Executor>(new Executor(std::move(name), coreWorkers, maxWorkers));
+}
+
+Executor* Executor::getDefault() {
+    static auto inst = [] {
+        size_t hardware = std::max(std::thread::hardware_concurrency(), 2u);
+        // the extra workers are there so that Tasks which block for a long
+        // time don't starve all the others. Tasks are allowed to wait on
+        // other Tasks, so the limit can't be a hard one
+        return new Executor("Geode Worker", hardware, std::max<size_t>(hardware * 4, 16), true);
+    }();
+    return inst;
+}
+
+Executor* Executor::getBlocking() {
+    static auto inst = new Executor("Geode Blocking Worker", 0, 0);
+    return inst;
+}
+
+void Executor::submit(Job job) {
+    m_impl->submit(std::move(job));
+}
+
+Executor::Metrics Executor::getMetrics() const {
+    size_t workers;
+    {
+        std::unique_lock lock(m_impl->m_mutex);
+        workers = m_impl->m_alive;
+    }
+    auto started = m_impl->m_started.load();
+    return Metrics {
+        .queueDepth = m_impl->m_pending.load(),
+        .activeWorkers = m_impl->m_active.load(),
+        .workers = workers,
+        .completedJobs = m_impl->m_completed.load(),
+        .averageLatency = std::chrono::nanoseconds(started ? m_impl->m_totalLatency.load() / static_cast<int64_t>(started) : 0),
+        .maxLatency = std::chrono::nanoseconds(m_impl->m_maxLatency.load()),
+    };
+}
+
+std::string const& Executor::getName() const {
+    return m_impl->m_name;
+}
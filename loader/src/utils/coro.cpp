@@ -20,7 +20,7 @@ namespace geode::utils::coro {
 	}
 
 	Task<void> sleep(double seconds) {
-		return Task<void>::run([seconds](auto, auto) {
+		return Task<void>::runOn(utils::thread::Executor::getBlocking(), [seconds](auto, auto) {
 			std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
 			return true;
 		}, "<Sleep>");
@@ -1,23 +1,33 @@
 #include <Geode/loader/Loader.hpp> // a third great circular dependency fix
 #include <Geode/loader/Log.hpp>
+#include <Geode/utils/Executor.hpp>
 #include <Geode/utils/file.hpp>
 #include <Geode/utils/map.hpp>
 #include <Geode/utils/string.hpp>
 #include <matjson.hpp>
 #include <mz.h>
 #include <mz_os.h>
+#include <mz_crypt.h>
 #include <mz_strm.h>
 #include <mz_strm_os.h>
 #include <mz_strm_mem.h>
 #include <mz_zip.h>
 #include <internal/FileWatcher.hpp>
 #include <Geode/utils/ranges.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_set>
 
 #ifdef GEODE_IS_WINDOWS
 # include <filesystem>
 #else
 # include <unistd.h>
 # include <fcntl.h>
+# include <sys/mman.h>
 # include <sys/stat.h>
 #endif
 
@@ -320,10 +330,175 @@ Result<std::vector<std::filesystem::path>> utils::file::readDirectory(
 
 static constexpr auto MAX_ENTRY_PATH_LEN = 256;
 
+// Entries are inflated through a buffer of this size, so extracting a large
+// file doesn't need to hold all of it in memory
+static constexpr size_t UNZIP_CHUNK_SIZE = 256 * 1024;
+// Archives smaller than this are extracted on the calling thread, as opening
+// more handles to the archive would take longer than inflating it does
+static constexpr uint64_t UNZIP_PARALLEL_MIN_SIZE = 1024 * 1024;
+static constexpr size_t UNZIP_MAX_WORKERS = 4;
+
 struct ZipEntry {
     bool isDirectory;
     int64_t compressedSize;
     int64_t uncompressedSize;
+    uint32_t crc32;
+    // Position of the entry in the central directory
+    int64_t position;
+    // Offset of the entry's local header in the archive
+    int64_t diskOffset;
+    uint16_t compressionMethod;
+    uint16_t flag;
+};
+
+// minizip checks the CRC-32 of the entries it reads itself, but entries
+// copied straight out of the archive have to be checked separately
+static uint32_t zipCRC32(std::span<uint8_t const> data) {
+    uint32_t crc = 0;
+    while (!data.empty()) {
+        auto chunk = std::min<size_t>(data.size(), INT32_MAX);
+        crc = mz_crypt_crc32_update(crc, data.data(), static_cast<int32_t>(chunk));
+        data = data.subspan(chunk);
+    }
+    return crc;
+}
+
+// Read-only mapping of a whole file, so reading a zip from disk doesn't go
+// through a syscall for every small read minizip makes
+class MappedFile final {
+private:
+    uint8_t const* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef GEODE_IS_WINDOWS
+    HANDLE m_mapping = nullptr;
+#endif
+
+    MappedFile() = default;
+
+public:
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    static Result<std::unique_ptr<MappedFile>> open(std::filesystem::path const& path) {
+        auto ret = std::unique_ptr<MappedFile>(new MappedFile());
+#ifdef GEODE_IS_WINDOWS
+        HANDLE file = CreateFileW(
+            path.native().c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr
+        );
+        if (file == INVALID_HANDLE_VALUE) {
+            return Err("Unable to open file: {}", formatError());
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            auto error = formatError();
+            CloseHandle(file);
+            return Err("Unable to get file size: {}", error);
+        }
+        if (size.QuadPart == 0) {
+            CloseHandle(file);
+            return Err("File is empty");
+        }
+
+        // The mapping keeps the file open on its own
+        ret->m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!ret->m_mapping) {
+            return Err("Unable to map file: {}", formatError());
+        }
+
+        auto data = MapViewOfFile(ret->m_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!data) {
+            return Err("Unable to map file: {}", formatError());
+        }
+        ret->m_data = static_cast<uint8_t const*>(data);
+        ret->m_size = static_cast<size_t>(size.QuadPart);
+#else
+        int file = ::open(path.native().c_str(), O_RDONLY);
+        if (file == -1) {
+            return Err("Unable to open file: {}", formatError());
+        }
+
+        struct stat fst;
+        if (fstat(file, &fst) == -1) {
+            auto error = formatError();
+            close(file);
+            return Err("Unable to get file size: {}", error);
+        }
+        if (fst.st_size == 0) {
+            close(file);
+            return Err("File is empty");
+        }
+
+        // The mapping stays valid after closing the descriptor
+        auto data = mmap(nullptr, fst.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (data == MAP_FAILED) {
+            return Err("Unable to map file: {}", formatError());
+        }
+        ret->m_data = static_cast<uint8_t const*>(data);
+        ret->m_size = static_cast<size_t>(fst.st_size);
+#endif
+        return Ok(std::move(ret));
+    }
+
+    std::span<uint8_t const> data() const {
+        return { m_data, m_size };
+    }
+
+    ~MappedFile() {
+#ifdef GEODE_IS_WINDOWS
+        if (m_data) {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping) {
+            CloseHandle(m_mapping);
+        }
+#else
+        if (m_data) {
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+        }
+#endif
+    }
+};
+
+struct ZipFileToExtract {
+    std::filesystem::path target;
+    // Position of the entry in the central directory
+    int64_t position;
+    int64_t uncompressedSize;
+};
+
+// Where the readers of a parallel extraction open the archive from; memory
+// archives are shared with the Unzip that started the extraction
+using ZipReaderSource = std::variant<std::filesystem::path, std::span<uint8_t const>>;
+
+// Shared between the thread calling extractAllTo and the workers helping it.
+// Workers that only get to run after the extraction has finished see that
+// it's closed and exit without touching the archive
+struct ZipExtractJob {
+    ZipReaderSource source;
+    std::vector<ZipFileToExtract> files;
+    std::atomic_size_t next = 0;
+    std::atomic_bool failed = false;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t finished = 0;
+    size_t active = 0;
+    bool closed = false;
+    std::optional<std::string> error;
+
+    // Only ever called from the thread calling extractAllTo
+    std::function<void(uint32_t, uint32_t)> progressCallback;
+    uint32_t progressBase = 0;
+    uint32_t progressTotal = 0;
 };
 
 class Zip::Impl final {
@@ -334,13 +509,33 @@ private:
     void* m_handle = nullptr;
     void* m_stream = nullptr;
     int32_t m_mode;
-    std::variant<Path, ByteVector> m_srcDest;
+    std::variant<Path, ByteVector, std::span<uint8_t const>> m_srcDest;
+    // Set when reading a zip from disk that could be memory-mapped
+    std::unique_ptr<MappedFile> m_mapping;
+    // The whole archive, when it's being read from memory
+    std::span<uint8_t const> m_memory;
     std::unordered_map<Path, ZipEntry, path_hash_t> m_entries;
     std::function<void(uint32_t, uint32_t)> m_progressCallback;
 
-    Result<> init() {
+    Result<> init(bool listEntries = true) {
+        // read files through a memory mapping when possible. The launch flag
+        // is there to compare against streaming, and as a way out if mapping
+        // misbehaves on some system
+        auto source = std::get_if<Path>(&m_srcDest);
+        if (
+            source && m_mode == MZ_OPEN_MODE_READ &&
+            !Loader::get()->getLaunchFlag("disable-zip-mapping")
+        ) {
+            if (auto mapping = MappedFile::open(*source)) {
+                m_mapping = std::move(mapping).unwrap();
+            }
+            else {
+                log::debug("Unable to map {}, reading it as a stream: {}", *source, mapping.unwrapErr());
+            }
+        }
+
         // open stream from file
-        if (std::holds_alternative<Path>(m_srcDest)) {
+        if (std::holds_alternative<Path>(m_srcDest) && !m_mapping) {
             auto& path = std::get<Path>(m_srcDest);
             // open file
             m_stream = mz_stream_os_create();
@@ -360,7 +555,16 @@ private:
         }
         // open stream from memory stream
         else {
-            auto& src = std::get<ByteVector>(m_srcDest);
+            std::span<uint8_t const> src;
+            if (m_mapping) {
+                src = m_mapping->data();
+            }
+            else if (auto data = std::get_if<ByteVector>(&m_srcDest)) {
+                src = *data;
+            }
+            else {
+                src = std::get<std::span<uint8_t const>>(m_srcDest);
+            }
             m_stream = mz_stream_mem_create();
             if (!m_stream) {
                 return Err("Unable to create memory stream");
@@ -368,7 +572,8 @@ private:
             // mz_stream_mem_set_buffer doesn't memcpy so we gotta store the data
             // elsewhere
             if (m_mode == MZ_OPEN_MODE_READ) {
-                mz_stream_mem_set_buffer(m_stream, src.data(), src.size());
+                mz_stream_mem_set_buffer(m_stream, const_cast<uint8_t*>(src.data()), src.size());
+                m_memory = src;
             }
             else {
                 mz_stream_mem_set_grow_size(m_stream, 128 * 1024);
@@ -388,7 +593,7 @@ private:
         }
 
         // get list of entries
-        if (!this->loadEntries()) {
+        if (listEntries && !this->loadEntries()) {
             return Err("Unable to read zip");
         }
 
@@ -413,6 +618,11 @@ private:
                 .isDirectory = mz_zip_entry_is_dir(m_handle) == MZ_OK,
                 .compressedSize = info->compressed_size,
                 .uncompressedSize = info->uncompressed_size,
+                .crc32 = info->crc,
+                .position = mz_zip_get_entry(m_handle),
+                .diskOffset = info->disk_offset,
+                .compressionMethod = info->compression_method,
+                .flag = info->flag,
             } });
 
             err = mz_zip_goto_next_entry(m_handle);
@@ -429,6 +639,118 @@ private:
         }
     }
 
+    // Lexical check so zip files like root/../../file.txt don't get extracted
+    // to avoid zip attacks. Both paths must already be normalized
+    static bool isContained(Path const& dir, Path const& target) {
+        auto relative = target.lexically_relative(dir);
+        return !relative.empty() && *relative.begin() != "..";
+    }
+
+    ZipReaderSource getReaderSource() const {
+        if (m_mapping) {
+            return m_mapping->data();
+        }
+        if (auto path = std::get_if<Path>(&m_srcDest)) {
+            return *path;
+        }
+        if (auto data = std::get_if<ByteVector>(&m_srcDest)) {
+            return std::span<uint8_t const>(*data);
+        }
+        return std::get<std::span<uint8_t const>>(m_srcDest);
+    }
+
+    // Open another read handle to the archive. The entry list isn't loaded
+    // since the handle is only used for extracting entries by position
+    static Result<std::unique_ptr<Impl>> openReader(ZipReaderSource const& source) {
+        auto ret = std::make_unique<Impl>();
+        ret->m_mode = MZ_OPEN_MODE_READ;
+        std::visit([&](auto const& src) { ret->m_srcDest = src; }, source);
+        GEODE_UNWRAP(ret->init(false));
+        return Ok(std::move(ret));
+    }
+
+    // Claim files from the job until there are none left. The calling thread
+    // passes its own handle, while workers open theirs once they have
+    // claimed a file
+    static void runExtractJob(ZipExtractJob& job, Impl* reader, bool reportProgress) {
+        std::unique_ptr<Impl> ownReader;
+        ByteVector buffer;
+        while (!job.failed) {
+            auto index = job.next++;
+            if (index >= job.files.size()) {
+                break;
+            }
+
+            auto res = [&]() -> Result<> {
+                if (!reader) {
+                    auto opened = openReader(job.source);
+                    if (!opened) {
+                        return Err("Unable to open zip: {}", opened.unwrapErr());
+                    }
+                    ownReader = std::move(opened).unwrap();
+                    reader = ownReader.get();
+                }
+                return reader->extractEntryTo(job.files[index], buffer);
+            }();
+
+            size_t finished;
+            {
+                std::lock_guard lock(job.mutex);
+                if (res) {
+                    job.finished += 1;
+                }
+                else if (!job.error) {
+                    job.error = res.unwrapErr();
+                    job.failed = true;
+                }
+                finished = job.finished;
+            }
+            job.cv.notify_all();
+
+            if (reportProgress && job.progressCallback) {
+                job.progressCallback(job.progressBase + finished, job.progressTotal);
+            }
+        }
+    }
+
+    Result<> extractInParallel(std::shared_ptr<ZipExtractJob> job, size_t workers) {
+        for (size_t i = 1; i < workers; i++) {
+            utils::thread::Executor::getDefault()->submit([job] {
+                {
+                    std::lock_guard lock(job->mutex);
+                    if (job->closed) {
+                        return;
+                    }
+                    job->active += 1;
+                }
+                runExtractJob(*job, nullptr, false);
+                {
+                    std::lock_guard lock(job->mutex);
+                    job->active -= 1;
+                }
+                job->cv.notify_all();
+            });
+        }
+
+        // Work on the calling thread as well, so the extraction still
+        // finishes even if the executor is too busy to run any workers
+        runExtractJob(*job, this, true);
+
+        std::unique_lock lock(job->mutex);
+        job->cv.wait(lock, [&] { return job->active == 0; });
+        job->closed = true;
+        if (job->error) {
+            return Err(std::move(*job->error));
+        }
+        auto finished = job->finished;
+        lock.unlock();
+
+        if (job->progressCallback) {
+            job->progressCallback(job->progressBase + finished, job->progressTotal);
+        }
+        return Ok();
+    }
+
 public:
     static Result<std::unique_ptr<Impl>> inFile(Path const& path, int32_t mode) {
         auto ret = std::make_unique<Impl>();
@@ -446,6 +768,14 @@ public:
         return Ok(std::move(ret));
     }
 
+    static Result<std::unique_ptr<Impl>> fromSpan(std::span<uint8_t const> raw) {
+        auto ret = std::make_unique<Impl>();
+        ret->m_mode = MZ_OPEN_MODE_READ;
+        ret->m_srcDest = raw;
+        GEODE_UNWRAP(ret->init());
+        return Ok(std::move(ret));
+    }
+
     static Result<std::unique_ptr<Impl>> intoMemory() {
         auto ret = std::make_unique<Impl>();
         ret->m_mode = MZ_OPEN_MODE_CREATE;
@@ -458,9 +788,18 @@ public:
         m_progressCallback = callback;
     }
 
-    Result<> extractAt(Path const& dir, Path const& name) {
-        auto entry = m_entries.at(name);
-
+    /**
+     * Stream an entry to disk through `buffer`, which is grown to the chunk
+     * size (or the size of the entry, if smaller) as needed. The target's
+     * directory must already exist
+     */
+    Result<> extractEntryTo(ZipFileToExtract const& file, ByteVector& buffer) {
+        GEODE_UNWRAP(
+            mzTry(mz_zip_goto_entry(m_handle, file.position))
+            .mapErr([&](auto error) {
+                return fmt::format("Unable to navigate to entry (code {})", error);
+            })
+        );
         GEODE_UNWRAP(
             mzTry(mz_zip_entry_read_open(m_handle, 0, nullptr))
             .mapErr([&](auto error) {
@@ -468,31 +807,43 @@ public:
             })
         );
 
-        // if the file is empty, its data is empty (duh)
-        if (!entry.uncompressedSize) {
-            return Ok();
+        std::ofstream out(file.target, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            mz_zip_entry_close(m_handle);
+            return Err("Unable to open {} for writing", file.target);
         }
 
-        ByteVector res;
-        res.resize(entry.uncompressedSize);
-        auto read = mz_zip_entry_read(m_handle, res.data(), entry.uncompressedSize);
-        if (read < 0) {
-            mz_zip_entry_close(m_handle);
-            return Err("Unable to read entry (code {})", read);
+        auto chunkSize = static_cast<size_t>(std::clamp<int64_t>(
+            file.uncompressedSize, 1, UNZIP_CHUNK_SIZE
+        ));
+        if (buffer.size() < chunkSize) {
+            buffer.resize(chunkSize);
+        }
+        while (true) {
+            auto read = mz_zip_entry_read(
+                m_handle, buffer.data(), static_cast<int32_t>(std::min(buffer.size(), UNZIP_CHUNK_SIZE))
+            );
+            if (read < 0) {
+                mz_zip_entry_close(m_handle);
+                return Err("Unable to read entry (code {})", read);
+            }
+            if (read == 0) {
+                break;
+            }
+            out.write(reinterpret_cast<char const*>(buffer.data()), read);
+            if (!out) {
+                mz_zip_entry_close(m_handle);
+                return Err("Unable to write to {}", file.target);
+            }
         }
 
         mz_zip_entry_close(m_handle);
-
-        GEODE_UNWRAP(file::createDirectoryAll((dir / name).parent_path()));
-        GEODE_UNWRAP(file::writeBinary(dir / name, res).mapErr([&](auto error) {
-            return fmt::format("Unable to write to {}: {}", dir / name, error);
-        }));
-
         return Ok();
     }
 
-    Result<> extractAllTo(Path const& dir) {
+    Result<> extractAllTo(Path const& dir, std::function<bool(Path const&)> const& filter = nullptr) {
         GEODE_UNWRAP(file::createDirectoryAll(dir));
+        auto root = dir.lexically_normal();
 
         GEODE_UNWRAP(
             mzTry(mz_zip_goto_first_entry(m_handle))
@@ -510,72 +861,150 @@ public:
             })
         );
 
-        uint32_t currentEntry = 0;
+        // Go through the central directory first, so every directory can be
+        // created before any of the files are written
+        auto job = std::make_shared<ZipExtractJob>();
+        std::unordered_set<Path, path_hash_t> directories;
+        uint64_t totalSize = 0;
         // while not at MZ_END_OF_LIST
         do {
             mz_zip_file* info = nullptr;
             if (mz_zip_entry_get_info(m_handle, &info) != MZ_OK) {
                 return Err("Unable to get entry info");
             }
-            currentEntry++;
 
             Path filePath;
             filePath.assign(info->filename, info->filename + info->filename_size);
 
-            // make sure zip files like root/../../file.txt don't get extracted to
-            // avoid zip attacks
-            std::error_code ec;
-            if (!std::filesystem::relative(dir / filePath, dir, ec).empty()) {
-                if (m_entries.at(filePath).isDirectory) {
-                    GEODE_UNWRAP(file::createDirectoryAll(dir / filePath));
-                }
-                else {
-                    GEODE_UNWRAP(this->extractAt(dir, filePath));
-                }
-                if (m_progressCallback) {
-                    m_progressCallback(currentEntry, numEntries);
-                }
-            }
-            else {
+            auto target = (root / filePath).lexically_normal();
+            if (!isContained(root, target)) {
                 log::error(
                     "Zip entry '{}' is not contained within zip bounds",
                     dir / filePath
                 );
+                continue;
+            }
 
-                if (ec) {
-                    return Err(fmt::format("Unable to check relative: {}", ec.message()));
-                }
+            if (mz_zip_entry_is_dir(m_handle) == MZ_OK) {
+                directories.insert(std::move(target));
+            }
+            else if (!filter || filter(filePath)) {
+                directories.insert(target.parent_path());
+                job->files.push_back(ZipFileToExtract {
+                    .target = std::move(target),
+                    .position = mz_zip_get_entry(m_handle),
+                    .uncompressedSize = info->uncompressed_size,
+                });
+                totalSize += std::max<int64_t>(info->uncompressed_size, 0);
             }
         } while (mz_zip_goto_next_entry(m_handle) == MZ_OK);
 
-        return Ok();
+        for (auto const& directory : directories) {
+            GEODE_UNWRAP(file::createDirectoryAll(directory));
+        }
+
+        // Directories and skipped entries count as done from here on
+        job->progressCallback = m_progressCallback;
+        job->progressTotal = static_cast<uint32_t>(numEntries);
+        job->progressBase = static_cast<uint32_t>(numEntries - job->files.size());
+        if (m_progressCallback && job->progressBase) {
+            m_progressCallback(job->progressBase, job->progressTotal);
+        }
+
+        auto workers = std::min<size_t>({
+            std::max(std::thread::hardware_concurrency(), 1u),
+            UNZIP_MAX_WORKERS,
+            job->files.size(),
+        });
+        if (workers <= 1 || totalSize < UNZIP_PARALLEL_MIN_SIZE) {
+            runExtractJob(*job, this, true);
+            if (job->error) {
+                return Err(std::move(*job->error));
+            }
+            return Ok();
+        }
+
+        // Start on the biggest files so no worker is left inflating a large
+        // one after the rest have finished
+        std::sort(job->files.begin(), job->files.end(), [](auto const& a, auto const& b) {
+            return a.uncompressedSize > b.uncompressedSize;
+        });
+        job->source = this->getReaderSource();
+        return this->extractInParallel(std::move(job), workers);
+    }
+
+    bool isStoredInMemory(ZipEntry const& entry) const {
+        return !m_memory.empty() &&
+            entry.compressionMethod == MZ_COMPRESS_METHOD_STORE &&
+            !(entry.flag & MZ_ZIP_FLAG_ENCRYPTED) &&
+            entry.compressedSize == entry.uncompressedSize;
+    }
+
+    Result<std::span<uint8_t const>> view(Path const& name, bool verify) const {
+        auto it = m_entries.find(name);
+        if (it == m_entries.end()) {
+            return Err("Entry not found");
+        }
+        auto const& entry = it->second;
+        if (entry.isDirectory) {
+            return Err("Entry is directory");
+        }
+        if (m_memory.empty()) {
+            return Err("Zip is not in memory");
+        }
+        if (!this->isStoredInMemory(entry)) {
+            return Err("Entry is compressed");
+        }
+
+        // The central directory doesn't say where the data starts, so that has
+        // to be read from the local header (signature, 22 bytes of fields we
+        // don't need, then the name and extra field lengths)
+        constexpr size_t LOCAL_HEADER_SIZE = 30;
+        auto offset = static_cast<uint64_t>(entry.diskOffset);
+        if (
+            entry.diskOffset < 0 || m_memory.size() < LOCAL_HEADER_SIZE ||
+            offset > m_memory.size() - LOCAL_HEADER_SIZE
+        ) {
+            return Err("Entry header is out of bounds");
+        }
+        auto header = m_memory.data() + offset;
+        auto readU16 = [&](size_t at) -> uint64_t {
+            return header[at] | (header[at + 1] << 8);
+        };
+        if (readU16(0) != 0x4b50 || readU16(2) != 0x0403) {
+            return Err("Entry has an invalid header");
+        }
+        auto start = offset + LOCAL_HEADER_SIZE + readU16(26) + readU16(28);
+        auto size = static_cast<uint64_t>(entry.uncompressedSize);
+        if (start > m_memory.size() || size > m_memory.size() - start) {
+            return Err("Entry data is out of bounds");
+        }
+        auto data = m_memory.subspan(start, size);
+        if (verify && zipCRC32(data) != entry.crc32) {
+            return Err("Entry data doesn't match its checksum");
+        }
+        return Ok(data);
     }
 
     Result<ByteVector> extract(Path const& name) {
-        if (!m_entries.count(name)) {
+        auto it = m_entries.find(name);
+        if (it == m_entries.end()) {
             return Err("Entry not found");
         }
 
-        auto entry = m_entries.at(name);
+        auto const& entry = it->second;
         if (entry.isDirectory) {
             return Err("Entry is directory");
         }
 
-        GEODE_UNWRAP(
-            mzTry(mz_zip_goto_first_entry(m_handle))
-            .mapErr([&](auto error) {
-                return fmt::format("Unable to navigate to first entry (code {})", error);
-            })
-        );
-
-        auto namestr = utils::string::pathToString(name);
+        // Entries stored without compression can be copied straight out
+        if (this->isStoredInMemory(entry)) {
+            GEODE_UNWRAP_INTO(auto data, this->view(name, true));
+            return Ok(ByteVector(data.begin(), data.end()));
+        }
 
         GEODE_UNWRAP(
-            mzTry(mz_zip_locate_entry(
-                m_handle,
-                namestr.c_str(),
-                1
-            ))
+            mzTry(mz_zip_goto_entry(m_handle, entry.position))
             .mapErr([&](auto error) {
                 return fmt::format("Unable to locate entry (code {})", error);
             })
@@ -680,7 +1109,7 @@ public:
         return Path();
     }
 
-    std::unordered_map<Path, ZipEntry, path_hash_t> getEntries() const {
+    std::unordered_map<Path, ZipEntry, path_hash_t> const& getEntries() const {
         return m_entries;
     }
 
@@ -716,6 +1145,11 @@ Result<Unzip> Unzip::create(ByteVector const& data) {
     return Ok(Unzip(std::move(impl)));
 }
 
+Result<Unzip> Unzip::create(std::span<uint8_t const> data) {
+    GEODE_UNWRAP_INTO(auto impl, Zip::Impl::fromSpan(data));
+    return Ok(Unzip(std::move(impl)));
+}
+
 Unzip::Path Unzip::getPath() const {
     return m_impl->getPath();
 }
@@ -734,12 +1168,31 @@ bool Unzip::hasEntry(Path const& name) {
     return m_impl->getEntries().count(name);
 }
 
+Result<Unzip::EntryInfo> Unzip::getEntryInfo(Path const& name) const {
+    auto const& entries = m_impl->getEntries();
+    auto it = entries.find(name);
+    if (it == entries.end()) {
+        return Err("Entry {} not found", name);
+    }
+    return Ok(EntryInfo {
+        .isDirectory = it->second.isDirectory,
+        .size = static_cast<uint64_t>(std::max<int64_t>(it->second.uncompressedSize, 0)),
+        .crc32 = it->second.crc32,
+    });
+}
+
 Result<ByteVector> Unzip::extract(Path const& name) {
     return m_impl->extract(name).mapErr([&](auto error) {
         return fmt::format("Unable to extract entry {}: {}", name, error);
     });
 }
 
+Result<std::span<uint8_t const>> Unzip::view(Path const& name, bool verify) const {
+    return m_impl->view(name, verify).mapErr([&](auto error) {
+        return fmt::format("Unable to view entry {}: {}", name, error);
+    });
+}
+
 Result<> Unzip::extractTo(Path const& name, Path const& path) {
     GEODE_UNWRAP_INTO(auto bytes, m_impl->extract(name).mapErr([&](auto error) {
         return fmt::format("Unable to extract entry {}: {}", name, error);
@@ -758,6 +1211,10 @@ Result<> Unzip::extractAllTo(Path const& dir) {
     return m_impl->extractAllTo(dir);
 }
 
+Result<> Unzip::extractAllTo(Path const& dir, std::function<bool(Path const&)> filter) {
+    return m_impl->extractAllTo(dir, filter);
+}
+
 Result<> Unzip::intoDir(
     Path const& from,
     Path const& to,
@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <fmt/core.h>
 #include <fstream>
+#include <limits>
 #include <matjson.hpp>
 #include <system_error>
 #define CURL_STATICLIB
@@ -16,7 +17,11 @@
 #include <Geode/utils/string.hpp>
 #include <Geode/utils/map.hpp>
 #include <Geode/utils/terminate.hpp>
+#include <Geode/utils/Executor.hpp>
 #include <sstream>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 using namespace geode::prelude;
 using namespace geode::utils::web;
@@ -349,6 +354,10 @@ public:
     std::optional<ByteVector> m_body;
     std::optional<std::chrono::seconds> m_timeout;
     std::optional<std::pair<std::uint64_t, std::uint64_t>> m_range;
+    std::optional<std::filesystem::path> m_downloadPath;
+    std::function<bool(std::span<uint8_t const>)> m_onChunk;
+    std::function<bool(std::span<uint8_t const>)> m_onChunkAsync;
+    std::function<bool(int)> m_onStreamStart;
     bool m_certVerification = true;
     bool m_transferBody = true;
     bool m_followRedirects = true;
@@ -370,6 +379,330 @@ public:
 
 std::atomic_size_t WebRequest::Impl::s_idCounter = 0;
 
+// How much of a streamed body may be waiting to be written before the
+// transfer is paused to let the writer catch up
+static constexpr size_t MAX_QUEUED_CHUNK_BYTES = 8 * 1024 * 1024;
+// Content-Length comes from the server, so only this much is reserved up
+// front for in-memory bodies; anything bigger grows the buffer as it arrives
+static constexpr size_t MAX_RESERVED_BODY_BYTES = 64 * 1024 * 1024;
+
+// Hands the chunks of a streamed body over from the engine thread, which
+// drives every transfer and so must only ever copy them, to a job on the
+// blocking executor that passes them on to the sink. If the sink falls
+// behind, the transfer is paused instead of the engine thread waiting
+class ChunkWriter final : public std::enable_shared_from_this<ChunkWriter> {
+public:
+    using Sink = std::function<bool(std::span<uint8_t const>)>;
+    enum class PushResult {
+        Queued,
+        // The chunk wasn't taken; the transfer should be paused until
+        // the callback given to push() is called
+        Full,
+        Failed,
+    };
+
+private:
+    Sink m_sink;
+    // Protects everything below
+    std::mutex m_mutex;
+    std::deque<ByteVector> m_chunks;
+    size_t m_queuedBytes = 0;
+    bool m_writing = false;
+    bool m_failed = false;
+    bool m_closing = false;
+    std::function<void()> m_onDrained;
+    std::function<void()> m_onClosed;
+
+    // Expects m_mutex to be held
+    void startWriting() {
+        if (!m_writing) {
+            m_writing = true;
+            utils::thread::Executor::getBlocking()->submit([self = shared_from_this()] {
+                self->write();
+            });
+        }
+    }
+
+    void write() {
+        std::unique_lock lock(m_mutex);
+        while (true) {
+            if (m_failed || m_queuedBytes <= MAX_QUEUED_CHUNK_BYTES / 2) {
+                if (auto onDrained = std::move(m_onDrained)) {
+                    m_onDrained = nullptr;
+                    lock.unlock();
+                    onDrained();
+                    lock.lock();
+                    continue;
+                }
+            }
+            if (m_chunks.empty()) {
+                m_writing = false;
+                if (m_closing) {
+                    auto onClosed = std::move(m_onClosed);
+                    m_onClosed = nullptr;
+                    lock.unlock();
+                    // Lets the sink close whatever it's writing to before
+                    // the transfer is reported as done
+                    m_sink = nullptr;
+                    if (onClosed) onClosed();
+                }
+                return;
+            }
+            auto chunk = std::move(m_chunks.front());
+            m_chunks.pop_front();
+            lock.unlock();
+
+            // once the sink has failed, whatever is left is thrown away
+            bool ok = m_failed || m_sink(chunk);
+
+            lock.lock();
+            m_queuedBytes -= chunk.size();
+            if (!ok) {
+                m_failed = true;
+            }
+        }
+    }
+
+public:
+    ChunkWriter(Sink sink) : m_sink(std::move(sink)) {}
+
+    // Called on the engine thread. `onDrained` is only kept if the chunk
+    // wasn't taken
+    PushResult push(std::span<uint8_t const> data, std::function<void()> onDrained) {
+        std::unique_lock lock(m_mutex);
+        if (m_failed || m_closing) {
+            return PushResult::Failed;
+        }
+        if (m_queuedBytes >= MAX_QUEUED_CHUNK_BYTES) {
+            m_onDrained = std::move(onDrained);
+            return PushResult::Full;
+        }
+        m_chunks.emplace_back(data.begin(), data.end());
+        m_queuedBytes += data.size();
+        this->startWriting();
+        return PushResult::Queued;
+    }
+
+    // Stops taking chunks. Once everything queued has been written (or
+    // thrown away if `discard` is set), the sink is destroyed and `onClosed`
+    // is called on the writer's thread
+    void close(bool discard, std::function<void()> onClosed) {
+        std::unique_lock lock(m_mutex);
+        m_closing = true;
+        m_onClosed = std::move(onClosed);
+        if (discard) {
+            m_failed = true;
+        }
+        this->startWriting();
+    }
+
+    bool failed() {
+        std::unique_lock lock(m_mutex);
+        return m_failed;
+    }
+};
+
+// Writes a streamed body to the request's file and passes it on to its
+// async chunk callback. The file is opened once the first chunk arrives and
+// closed when the sink is destroyed
+static ChunkWriter::Sink makeChunkSink(
+    std::optional<std::filesystem::path> path,
+    std::function<bool(std::span<uint8_t const>)> onChunk
+) {
+    auto file = std::make_shared<std::ofstream>();
+    return [path = std::move(path), onChunk = std::move(onChunk), file](std::span<uint8_t const> data) {
+        if (path) {
+            if (!file->is_open()) {
+                file->open(*path, std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!*file) {
+                    log::error("Unable to open {} for writing", *path);
+                    return false;
+                }
+            }
+            if (!file->write(reinterpret_cast<char const*>(data.data()), data.size())) {
+                return false;
+            }
+        }
+        return !onChunk || data.empty() || onChunk(data);
+    };
+}
+
+// Drives every WebRequest's transfer from a single background thread
+// through one curl multi handle, so that connections (including HTTP/2
+// multiplexing), TLS sessions and DNS lookups are reused across requests
+// instead of every request doing its own handshake
+class WebEngine final {
+private:
+    struct Transfer {
+        CURL* curl;
+        std::function<bool()> isCancelled;
+        std::function<void(CURLcode)> onDone;
+    };
+
+    CURLM* m_multi;
+    CURLSH* m_share;
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<Transfer>> m_queued;
+    std::vector<CURL*> m_unpaused;
+    ConnectionLimits m_limits;
+    bool m_limitsChanged = true;
+    // Only touched by the engine thread
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> m_active;
+
+    WebEngine() {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        m_multi = curl_multi_init();
+        curl_multi_setopt(m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+        // the share handle is only ever used from the engine thread, so it
+        // doesn't need lock callbacks
+        m_share = curl_share_init();
+        curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+        std::thread([this] {
+            utils::thread::setName("Web Engine");
+            this->run();
+        }).detach();
+    }
+
+    void applyLimits() {
+        std::unique_lock lock(m_mutex);
+        if (!m_limitsChanged) return;
+        m_limitsChanged = false;
+        curl_multi_setopt(m_multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(m_limits.maxConnectionsPerHost));
+        curl_multi_setopt(m_multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, static_cast<long>(m_limits.maxConnections));
+        curl_multi_setopt(m_multi, CURLMOPT_MAXCONNECTS, static_cast<long>(m_limits.maxCachedConnections));
+    }
+
+    void addQueued() {
+        std::vector<std::unique_ptr<Transfer>> queued;
+        {
+            std::unique_lock lock(m_mutex);
+            queued.swap(m_queued);
+        }
+        for (auto& transfer : queued) {
+            auto curl = transfer->curl;
+            curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+            auto code = curl_multi_add_handle(m_multi, curl);
+            if (code != CURLM_OK) {
+                log::error("Failed to add request to curl multi handle: {}", curl_multi_strerror(code));
+                transfer->onDone(CURLE_FAILED_INIT);
+                continue;
+            }
+            m_active.emplace(curl, std::move(transfer));
+        }
+    }
+
+    void resumeUnpaused() {
+        std::vector<CURL*> unpaused;
+        {
+            std::unique_lock lock(m_mutex);
+            unpaused.swap(m_unpaused);
+        }
+        for (auto curl : unpaused) {
+            // the transfer may have finished (or been cancelled) since
+            if (m_active.contains(curl)) {
+                curl_easy_pause(curl, CURLPAUSE_CONT);
+            }
+        }
+    }
+
+    void finish(CURL* curl, CURLcode code) {
+        auto it = m_active.find(curl);
+        if (it == m_active.end()) return;
+        auto transfer = std::move(it->second);
+        m_active.erase(it);
+        curl_multi_remove_handle(m_multi, curl);
+        curl_easy_setopt(curl, CURLOPT_SHARE, nullptr);
+        transfer->onDone(code);
+    }
+
+    void run() {
+        while (true) {
+            this->applyLimits();
+            this->addQueued();
+            this->resumeUnpaused();
+
+            int running = 0;
+            curl_multi_perform(m_multi, &running);
+
+            int remaining = 0;
+            while (auto msg = curl_multi_info_read(m_multi, &remaining)) {
+                if (msg->msg == CURLMSG_DONE) {
+                    this->finish(msg->easy_handle, msg->data.result);
+                }
+            }
+
+            // transfers that are still waiting for a free connection don't
+            // get progress callbacks, so cancellation has to be checked here
+            std::vector<CURL*> cancelled;
+            for (auto& [curl, transfer] : m_active) {
+                if (transfer->isCancelled()) {
+                    cancelled.push_back(curl);
+                }
+            }
+            for (auto curl : cancelled) {
+                this->finish(curl, CURLE_ABORTED_BY_CALLBACK);
+            }
+
+            // sleeps until there is socket activity, curl's next timeout,
+            // or a new request is added (which wakes the poll up)
+            curl_multi_poll(m_multi, nullptr, 0, m_active.empty() ? 1000 : 100, nullptr);
+        }
+    }
+
+public:
+    static WebEngine& get() {
+        static auto inst = new WebEngine();
+        return *inst;
+    }
+
+    void add(CURL* curl, std::function<bool()> isCancelled, std::function<void(CURLcode)> onDone) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_queued.push_back(std::make_unique<Transfer>(Transfer {
+                .curl = curl,
+                .isCancelled = std::move(isCancelled),
+                .onDone = std::move(onDone),
+            }));
+        }
+        curl_multi_wakeup(m_multi);
+    }
+
+    // Resume a transfer that was paused from its write callback. Can be
+    // called from any thread, as pausing only has an effect on the engine's
+    void unpause(CURL* curl) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_unpaused.push_back(curl);
+        }
+        curl_multi_wakeup(m_multi);
+    }
+
+    ConnectionLimits getLimits() {
+        std::unique_lock lock(m_mutex);
+        return m_limits;
+    }
+
+    void setLimits(ConnectionLimits const& limits) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_limits = limits;
+            m_limitsChanged = true;
+        }
+        curl_multi_wakeup(m_multi);
+    }
+};
+
+ConnectionLimits geode::utils::web::getConnectionLimits() {
+    return WebEngine::get().getLimits();
+}
+
+void geode::utils::web::setConnectionLimits(ConnectionLimits const& limits) {
+    WebEngine::get().setLimits(limits);
+}
+
 WebRequest::WebRequest() : m_impl(std::make_shared<Impl>()) {}
 WebRequest::~WebRequest() {}
 
@@ -390,40 +723,99 @@ static std::string urlParamEncode(std::string_view input) {
 WebTask WebRequest::send(std::string_view method, std::string_view url) {
     m_impl->m_method = method;
     m_impl->m_url = url;
-    return WebTask::run([impl = m_impl](auto progress, auto hasBeenCancelled) -> WebTask::Result {
+    // This only sets up the transfer; the transfer itself is driven by the
+    // shared WebEngine, which calls finish once it is done
+    return WebTask::runWithCallback([impl = m_impl](auto finish, auto progress, auto hasBeenCancelled) {
         // Init Curl
         auto curl = curl_easy_init();
         if (!curl) {
             log::error("Failed to initialize cURL");
-            return impl->makeError(-1, "Failed to initialize curl");
+            return finish(impl->makeError(-1, "Failed to initialize curl"));
         }
 
-        // todo: in the future, we might want to support downloading directly into
-        // files / in-memory streams like the old AsyncWebRequest class
-
-        // Struct that holds values for the curl callbacks
+        // Struct that holds values for the curl callbacks; must stay alive
+        // until the engine is done with the transfer
         struct ResponseData {
             WebResponse response;
             Impl* impl;
+            CURL* curl;
             WebTask::PostProgress progress;
             WebTask::HasBeenCancelled hasBeenCancelled;
-        } responseData = {
+            curl_slist* headers = nullptr;
+            // If an error happens, we want to get a more specific description of the issue
+            char errorBuf[CURL_ERROR_SIZE] = { '\0' };
+            // Whether the body is going to the request's file / chunk sinks
+            // instead of memory; decided once the first chunk arrives
+            std::optional<bool> streaming;
+            // Passes the body on to downloadTo's file and onChunkAsync
+            std::shared_ptr<ChunkWriter> writer;
+        };
+        auto responseData = std::shared_ptr<ResponseData>(new ResponseData {
             .response = WebResponse(),
             .impl = impl.get(),
+            .curl = curl,
             .progress = progress,
             .hasBeenCancelled = hasBeenCancelled,
-        };
+        });
+
+        // Store downloaded response data into a byte vector, or pass it on
+        // to the sinks as it arrives
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, responseData.get());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +[](char* data, size_t size, size_t nmemb, void* ptr) -> size_t {
+            auto res = static_cast<ResponseData*>(ptr);
+            auto bytes = size * nmemb;
+            auto& target = res->response.m_impl->m_data;
+
+            if (!res->streaming) {
+                // only successful bodies are streamed; error bodies are small
+                // and kept in memory so they can still be read from the response
+                long code = 0;
+                curl_easy_getinfo(res->curl, CURLINFO_RESPONSE_CODE, &code);
+                res->streaming = (res->impl->m_downloadPath || res->impl->m_onChunk || res->impl->m_onChunkAsync) &&
+                    200 <= code && code < 300;
+
+                if (*res->streaming && res->impl->m_onStreamStart && !res->impl->m_onStreamStart(static_cast<int>(code))) {
+                    return 0;
+                }
+                if (*res->streaming && (res->impl->m_downloadPath || res->impl->m_onChunkAsync)) {
+                    res->writer = std::make_shared<ChunkWriter>(
+                        makeChunkSink(res->impl->m_downloadPath, res->impl->m_onChunkAsync)
+                    );
+                }
+                if (!*res->streaming) {
+                    curl_off_t length = -1;
+                    curl_easy_getinfo(res->curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+                    if (length > 0) {
+                        target.reserve(std::min(static_cast<uint64_t>(length), static_cast<uint64_t>(MAX_RESERVED_BODY_BYTES)));
+                    }
+                }
+            }
 
-        // Store downloaded response data into a byte vector
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseData);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +[](char* data, size_t size, size_t nmemb, void* ptr) {
-            auto& target = static_cast<ResponseData*>(ptr)->response.m_impl->m_data;
-            target.insert(target.end(), data, data + size * nmemb);
-            return size * nmemb;
+            if (!*res->streaming) {
+                target.insert(target.end(), data, data + bytes);
+                return bytes;
+            }
+            if (res->writer) {
+                auto push = res->writer->push(
+                    std::span(reinterpret_cast<uint8_t const*>(data), bytes),
+                    [curl = res->curl] { WebEngine::get().unpause(curl); }
+                );
+                if (push == ChunkWriter::PushResult::Full) {
+                    // curl hands the same data over again once unpaused
+                    return CURL_WRITEFUNC_PAUSE;
+                }
+                if (push == ChunkWriter::PushResult::Failed) {
+                    return 0;
+                }
+            }
+            if (res->impl->m_onChunk && !res->impl->m_onChunk(std::span(reinterpret_cast<uint8_t const*>(data), bytes))) {
+                return 0;
+            }
+            return bytes;
         });
 
         // Set headers
-        curl_slist* headers = nullptr;
+        auto& headers = responseData->headers;
         for (auto& [name, values] : impl->m_headers) {
             // Sanitize header name
             auto header = name;
@@ -522,7 +914,11 @@ WebTask WebRequest::send(std::string_view method, std::string_view url) {
 
         // Set range
         if (impl->m_range) {
-            curl_easy_setopt(curl, CURLOPT_RANGE, fmt::format("{}-{}", impl->m_range->first, impl->m_range->second).c_str());
+            // an end of UINT64_MAX means "until the end of the body"
+            auto range = impl->m_range->second == std::numeric_limits<std::uint64_t>::max() ?
+                fmt::format("{}-", impl->m_range->first) :
+                fmt::format("{}-{}", impl->m_range->first, impl->m_range->second);
+            curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
         }
 
         // Set proxy options
@@ -607,13 +1003,10 @@ WebTask WebRequest::send(std::string_view method, std::string_view url) {
             });
         }
 
-        // If an error happens, we want to get a more specific description of the issue
-        char errorBuf[CURL_ERROR_SIZE];
-        errorBuf[0] = '\0';
-        curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errorBuf);
+        curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, responseData->errorBuf);
 
         // Get headers from the response
-        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &responseData);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, responseData.get());
         curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, (+[](char* buffer, size_t size, size_t nitems, void* ptr) {
             auto& headers = static_cast<ResponseData*>(ptr)->response.m_impl->m_headers;
             std::string line;
@@ -637,7 +1030,7 @@ WebTask WebRequest::send(std::string_view method, std::string_view url) {
         }));
 
         // Track & post progress on the Promise
-        curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, &responseData);
+        curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, responseData.get());
         curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, +[](void* ptr, double dtotal, double dnow, double utotal, double unow) -> int {
             auto data = static_cast<ResponseData*>(ptr);
 
@@ -658,42 +1051,66 @@ WebTask WebRequest::send(std::string_view method, std::string_view url) {
             return 0;
         });
 
-        // Make the actual web request
-        auto curlResponse = curl_easy_perform(curl);
-
-        // Get the response code; note that this will be invalid if the
-        // curlResponse is not CURLE_OK
-        long code = 0;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
-        responseData.response.m_impl->m_code = static_cast<int>(code);
-
-        responseData.response.m_impl->m_errMessage = std::string(errorBuf);
+        // Hand the transfer over to the engine
+        WebEngine::get().add(curl, hasBeenCancelled, [curl, impl, responseData, finish](CURLcode curlResponse) {
+            auto errorBuf = responseData->errorBuf;
+
+            // Get the response code; note that this will be invalid if the
+            // curlResponse is not CURLE_OK
+            long code = 0;
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+            responseData->response.m_impl->m_code = static_cast<int>(code);
+
+            responseData->response.m_impl->m_errMessage = std::string(errorBuf);
+
+            // Free up curl memory
+            curl_slist_free_all(responseData->headers);
+            curl_easy_cleanup(curl);
+
+            auto resolve = [curlResponse, impl, responseData, finish] {
+                auto errorBuf = responseData->errorBuf;
+
+                // Check if the request failed on curl's side or because of cancellation
+                if (curlResponse != CURLE_OK) {
+                    if (responseData->hasBeenCancelled()) {
+                        log::debug("Request cancelled");
+                        return finish(WebTask::Cancel());
+                    }
+                    else {
+                        std::string const err = curl_easy_strerror(curlResponse);
+                        log::error("cURL failure, error: {}", err);
+                        log::warn("Error buffer: {}", errorBuf);
+                        return finish(impl->makeError(
+                            -1,
+                            !*errorBuf ?
+                                  fmt::format("Curl failed: {}", err)
+                                : fmt::format("Curl failed: {} ({})", err, errorBuf)
+                        ));
+                    }
+                }
 
-        // Free up curl memory
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
+                // resolve with success :-)
+                finish(std::move(responseData->response));
+            };
 
-        // Check if the request failed on curl's side or because of cancellation
-        if (curlResponse != CURLE_OK) {
-            if (hasBeenCancelled()) {
-                log::debug("Request cancelled");
-                return WebTask::Cancel();
+            // Make sure the file exists even if the body was empty
+            auto writer = responseData->writer;
+            if (curlResponse == CURLE_OK && impl->m_downloadPath && !responseData->streaming && responseData->response.ok()) {
+                writer = std::make_shared<ChunkWriter>(makeChunkSink(impl->m_downloadPath, nullptr));
+                (void)writer->push({}, nullptr);
             }
-            else {
-                std::string const err = curl_easy_strerror(curlResponse);
-                log::error("cURL failure, error: {}", err);
-                log::warn("Error buffer: {}", errorBuf);
-                return impl->makeError(
-                    -1,
-                    !*errorBuf ?
-                          fmt::format("Curl failed: {}", err)
-                        : fmt::format("Curl failed: {} ({})", err, errorBuf)
-                );
+            if (!writer) {
+                return resolve();
             }
-        }
-
-        // resolve with success :-)
-        return std::move(responseData.response);
+            // The file is only complete once the writer has caught up, which
+            // the engine thread mustn't wait for
+            writer->close(curlResponse != CURLE_OK, [curlResponse, impl, writer, finish, resolve] {
+                if (curlResponse == CURLE_OK && writer->failed()) {
+                    return finish(impl->makeError(-1, "Failed to write the response body"));
+                }
+                resolve();
+            });
+        });
     }, fmt::format("{} {}", method, url));
 }
 WebTask WebRequest::post(std::string_view url) {
@@ -781,6 +1198,26 @@ WebRequest& WebRequest::downloadRange(std::pair<std::uint64_t, std::uint64_t> by
     return *this;
 }
 
+WebRequest& WebRequest::downloadTo(std::filesystem::path const& path) {
+    m_impl->m_downloadPath = path;
+    return *this;
+}
+
+WebRequest& WebRequest::onChunk(std::function<bool(std::span<uint8_t const>)> callback) {
+    m_impl->m_onChunk = std::move(callback);
+    return *this;
+}
+
+WebRequest& WebRequest::onChunkAsync(std::function<bool(std::span<uint8_t const>)> callback) {
+    m_impl->m_onChunkAsync = std::move(callback);
+    return *this;
+}
+
+WebRequest& WebRequest::onStreamStart(std::function<bool(int)> callback) {
+    m_impl->m_onStreamStart = std::move(callback);
+    return *this;
+}
+
 WebRequest& WebRequest::certVerification(bool enabled) {
     m_impl->m_certVerification = enabled;
     return *this;
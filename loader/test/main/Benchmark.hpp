@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Geode/loader/Log.hpp>
+#include <Geode/loader/Mod.hpp>
+#include <chrono>
+#include <string_view>
+
+// Benchmarks only run when the game is launched with `--geode:geode.test.bench=true`,
+// since some of them take a few seconds
+inline bool shouldRunBenchmarks() {
+    return geode::Mod::get()->getLaunchFlag("bench");
+}
+
+// Calls `fn` `iterations` times and logs the average time per call
+template <class F>
+void benchmark(std::string_view name, size_t iterations, F&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        fn(i);
+    }
+    auto time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    geode::log::info(
+        "[bench] {}: {:.1f}ns per iteration ({} iterations, {:.1f}ms total)",
+        name, time.count() / iterations, iterations, time.count() / 1'000'000
+    );
+}
@@ -0,0 +1,62 @@
+#include <Geode/utils/casts.hpp>
+#include "Benchmark.hpp"
+
+using namespace geode::prelude;
+
+namespace {
+    // Two levels of multiple inheritance, so that casts need more than a
+    // single lookup in the RTTI
+    struct CastA { virtual ~CastA() = default; int a = 1; };
+    struct CastB { virtual ~CastB() = default; int b = 2; };
+    struct CastC : CastA, CastB { int c = 3; };
+    struct CastD { virtual ~CastD() = default; int d = 4; };
+    struct CastE : CastD, CastC { int e = 5; };
+    struct CastUnrelated { virtual ~CastUnrelated() = default; };
+}
+
+// Keeps the compiler from figuring out the dynamic type
+template <class T>
+static T* launder(T* value) {
+    static T* volatile sink;
+    sink = value;
+    return sink;
+}
+
+$on_mod(Loaded) {
+    CastE object;
+    CastB* asB = launder<CastB>(&object);
+    CastA* asA = launder<CastA>(&object);
+
+    // typeinfo_cast has to agree with dynamic_cast for down-, cross- and
+    // failed casts, both on the first (uncached) and later (cached) calls
+    for (size_t i = 0; i < 2; i++) {
+        if (cast::typeinfo_cast<CastE*>(asB) != dynamic_cast<CastE*>(asB)) {
+            log::error("typeinfo_cast downcast doesn't match dynamic_cast");
+        }
+        if (cast::typeinfo_cast<CastD*>(asB) != dynamic_cast<CastD*>(asB)) {
+            log::error("typeinfo_cast cross cast doesn't match dynamic_cast");
+        }
+        if (cast::typeinfo_cast<CastA*>(asB) != dynamic_cast<CastA*>(asB)) {
+            log::error("typeinfo_cast sibling cast doesn't match dynamic_cast");
+        }
+        if (cast::typeinfo_cast<CastUnrelated*>(asA) != nullptr) {
+            log::error("typeinfo_cast to an unrelated type didn't fail");
+        }
+    }
+
+    if (!shouldRunBenchmarks()) return;
+
+    size_t found = 0;
+    benchmark("dynamic_cast CastB -> CastD", 10'000'000, [&](size_t) {
+        found += dynamic_cast<CastD*>(launder(asB)) != nullptr;
+    });
+    benchmark("typeinfo_cast CastB -> CastD", 10'000'000, [&](size_t) {
+        found += cast::typeinfo_cast<CastD*>(launder(asB)) != nullptr;
+    });
+    benchmark("typeinfo_cast CastA -> CastUnrelated", 10'000'000, [&](size_t) {
+        found += cast::typeinfo_cast<CastUnrelated*>(launder(asA)) != nullptr;
+    });
+    if (found != 20'000'000) {
+        log::error("Expected 20000000 successful casts, got {}", found);
+    }
+}
@@ -0,0 +1,158 @@
+#include <Geode/loader/Event.hpp>
+#include <thread>
+#include "Benchmark.hpp"
+
+using namespace geode::prelude;
+
+namespace {
+    struct BenchEvent : public Event {
+        size_t value;
+        BenchEvent(size_t value) : value(value) {}
+    };
+    struct DerivedBenchEvent : public BenchEvent {
+        using BenchEvent::BenchEvent;
+    };
+    // An event type none of the benchmarks below post
+    struct UnrelatedEvent : public Event {};
+
+    // Puts listeners in the global pool, where every listener was before
+    // events got per-type pools, so that both can be compared
+    template <class T>
+    struct GlobalPoolFilter : public EventFilter<T> {
+        EventListenerPool* getPool() const {
+            return DefaultEventListenerPool::get();
+        }
+    };
+
+    // Post BenchEvent with `count` listeners for an unrelated event around.
+    // `Unrelated` and `Received` pick the pool through their filter
+    template <class Unrelated, class Received>
+    void benchmarkPost(std::string_view pool, size_t count) {
+        // Destroying these at the end removes them from the pool again
+        std::vector<EventListener<Unrelated>> unrelated;
+        unrelated.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            unrelated.emplace_back([](UnrelatedEvent*) {
+                return ListenerResult::Propagate;
+            });
+        }
+        size_t received = 0;
+        EventListener<Received> listener([&](BenchEvent*) {
+            received += 1;
+            return ListenerResult::Propagate;
+        });
+
+        // The global pool costs a cast per listener, so keep the total work
+        // roughly the same for every count
+        auto iterations = std::max<size_t>(1000, 10'000'000 / count);
+        benchmark(
+            fmt::format("post BenchEvent, {} pool, {} other listeners", pool, count),
+            iterations, [](size_t i) {
+                BenchEvent(i).post();
+            }
+        );
+        if (received != iterations) {
+            log::error("Expected {} events to be received, got {}", iterations, received);
+        }
+    }
+}
+
+$on_mod(Loaded) {
+    if (!shouldRunBenchmarks()) return;
+
+    for (size_t count : { 10, 1'000, 10'000 }) {
+        benchmarkPost<GlobalPoolFilter<UnrelatedEvent>, GlobalPoolFilter<BenchEvent>>("global", count);
+        benchmarkPost<UnrelatedEvent, BenchEvent>("typed", count);
+    }
+
+    std::atomic_size_t received = 0;
+    EventListener<BenchEvent> base([&](BenchEvent* ev) {
+        received += 1;
+        return ListenerResult::Propagate;
+    });
+    EventListener<DerivedBenchEvent> derived([&](DerivedBenchEvent* ev) {
+        received += 1;
+        return ListenerResult::Propagate;
+    });
+
+    benchmark("post BenchEvent", 1'000'000, [](size_t i) {
+        BenchEvent(i).post();
+    });
+    benchmark("post DerivedBenchEvent", 1'000'000, [](size_t i) {
+        DerivedBenchEvent(i).post();
+    });
+
+    // posting from several threads at once shouldn't contend on anything
+    benchmark("post DerivedBenchEvent from 4 threads", 1, [](size_t) {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < 4; t++) {
+            threads.emplace_back([] {
+                for (size_t i = 0; i < 250'000; i++) {
+                    DerivedBenchEvent(i).post();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    });
+
+    // every derived event reaches both listeners
+    if (received != 5'000'000) {
+        log::error("Expected 5000000 events to be received, got {}", received.load());
+    }
+}
+
+namespace {
+    struct StressEvent : public Event {};
+
+    // Peeks at how many retired snapshots a pool is holding on to
+    struct PoolInspector : public DefaultEventListenerPool {
+        static size_t retiredCount(DefaultEventListenerPool* pool) {
+            auto data = static_cast<PoolInspector*>(pool)->m_data.get();
+            std::unique_lock lock(data->m_mutex);
+            return data->m_retiredSnapshots.size() + data->m_retiredEntries.size();
+        }
+    };
+}
+
+// Listeners being added and removed while other threads never stop posting
+// must not make the pool hold on to retired snapshots forever
+$on_mod(Loaded) {
+    if (!shouldRunBenchmarks()) return;
+
+    std::atomic_bool running = true;
+    std::vector<std::thread> posters;
+    for (size_t t = 0; t < 4; t++) {
+        posters.emplace_back([&] {
+            while (running) {
+                StressEvent().post();
+            }
+        });
+    }
+
+    auto pool = DefaultEventListenerPool::getForType<StressEvent>();
+    size_t maxRetired = 0;
+    benchmark("add and remove listeners while posting", 100'000, [&](size_t i) {
+        EventListener<StressEvent> listener([](StressEvent*) {
+            return ListenerResult::Propagate;
+        });
+        if (i % 1000 == 0) {
+            maxRetired = std::max(maxRetired, PoolInspector::retiredCount(pool));
+        }
+    });
+    running = false;
+    for (auto& thread : posters) {
+        thread.join();
+    }
+
+    log::info("[bench] most retired snapshots and entries held at once: {}", maxRetired);
+    // once nobody is posting anymore, removing a listener frees everything
+    EventListener<StressEvent> listener([](StressEvent*) {
+        return ListenerResult::Propagate;
+    });
+    listener.disable();
+    if (auto retired = PoolInspector::retiredCount(pool)) {
+        log::error("Pool still holds {} retired snapshots and entries after posting stopped", retired);
+    }
+}
@@ -0,0 +1,110 @@
+#include <Geode/cocos/base_nodes/CCNode.h>
+#include <Geode/cocos/cocoa/CCArray.h>
+#include "Benchmark.hpp"
+
+using namespace geode::prelude;
+
+$on_mod(Loaded) {
+    // enough children for the parent to get a child ID index
+    Ref<CCNode> parent = CCNode::create();
+    for (size_t i = 0; i < 32; i++) {
+        auto child = CCNode::create();
+        child->setID(fmt::format("child-{}", i));
+        parent->addChild(child);
+    }
+
+    // lookups only read the parent, so they must not give it metadata
+    if (parent->getChildByID("child-20") == nullptr) {
+        log::error("getChildByID didn't find a child");
+    }
+    if (parent->m_pUserObject != nullptr) {
+        log::error("getChildByID attached metadata to the parent");
+    }
+
+    // now with an index, since setting an ID gives the parent metadata
+    parent->setID("parent");
+    auto child = parent->getChildByID("child-20");
+    if (child == nullptr || child->getID() != "child-20") {
+        log::error("getChildByID returned the wrong child");
+    }
+
+    // misses are answered by the index, which has to follow renames
+    child->setID("child-20-renamed");
+    if (parent->getChildByID("child-20") != nullptr) {
+        log::error("getChildByID found a child by its old ID");
+    }
+    if (parent->getChildByID("child-20-renamed") != child) {
+        log::error("getChildByID didn't find a renamed child");
+    }
+
+    // shared IDs go by child order, including after one of them is removed
+    auto first = CCNode::create();
+    first->setID("shared");
+    auto second = CCNode::create();
+    second->setID("shared");
+    parent->addChild(first);
+    parent->addChild(second);
+    if (parent->getChildByID("shared") != first) {
+        log::error("getChildByID didn't return the first child with a shared ID");
+    }
+    first->removeFromParent();
+    if (parent->getChildByID("shared") != second) {
+        log::error("getChildByID didn't return the remaining child with a shared ID");
+    }
+
+    // children can be removed and added behind the index's back, which it
+    // notices by the child count changing
+    parent->getChildren()->removeObject(child);
+    if (parent->getChildByID("child-20-renamed") != nullptr) {
+        log::error("getChildByID returned a child that was removed");
+    }
+    auto direct = CCNode::create();
+    direct->setID("direct");
+    parent->getChildren()->addObject(direct);
+    if (parent->getChildByID("direct") != direct) {
+        log::error("getChildByID didn't find a child added to the array directly");
+    }
+
+    if (!shouldRunBenchmarks()) return;
+
+    std::vector<std::string> ids;
+    for (size_t i = 0; i < 20; i++) {
+        ids.push_back(fmt::format("child-{}", i));
+    }
+    size_t found = 0;
+    benchmark("getChildByID (32 children)", 1'000'000, [&](size_t i) {
+        found += parent->getChildByID(ids[i % ids.size()]) != nullptr;
+    });
+    if (found != 1'000'000) {
+        log::error("Expected 1000000 children found, got {}", found);
+    }
+
+    // a scan would go through every child for the misses and the
+    // children near the end
+    Ref<CCNode> large = CCNode::create();
+    large->setID("large");
+    for (size_t i = 0; i < 10'000; i++) {
+        auto child = CCNode::create();
+        child->setID(fmt::format("large-{}", i));
+        large->addChild(child);
+    }
+    std::vector<std::string> largeIDs;
+    for (size_t i = 0; i < 10'000; i += 97) {
+        largeIDs.push_back(fmt::format("large-{}", i));
+    }
+    found = 0;
+    benchmark("getChildByID hit (10000 children)", 1'000'000, [&](size_t i) {
+        found += large->getChildByID(largeIDs[i % largeIDs.size()]) != nullptr;
+    });
+    if (found != 1'000'000) {
+        log::error("Expected 1000000 children found, got {}", found);
+    }
+    // an ID that is interned, so the lookup gets to the index
+    found = 0;
+    benchmark("getChildByID miss (10000 children)", 1'000'000, [&](size_t) {
+        found += large->getChildByID("child-0") != nullptr;
+    });
+    if (found != 0) {
+        log::error("Expected no children found, got {}", found);
+    }
+}
@@ -0,0 +1,31 @@
+#include <Geode/loader/Mod.hpp>
+#include <Geode/utils/file.hpp>
+#include <chrono>
+
+using namespace geode::prelude;
+
+$on_mod(Loaded) {
+    // saveData only writes files whose contents changed, which has to
+    // include changes made through a reference held from before the last save
+    auto& saved = Mod::get()->getSaveContainer();
+    (void)Mod::get()->saveData();
+
+    auto token = static_cast<int64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    saved["held-reference-test"] = token;
+    if (auto res = Mod::get()->saveData(); !res) {
+        log::error("Unable to save data: {}", res.unwrapErr());
+        return;
+    }
+
+    auto json = file::readJson(Mod::get()->getSaveDir() / "saved.json");
+    if (!json) {
+        log::error("Unable to read saved.json: {}", json.unwrapErr());
+        return;
+    }
+    auto written = json.unwrap().get("held-reference-test").andThen([](auto&& value) {
+        return value.template as<int64_t>();
+    });
+    if (!written || written.unwrap() != token) {
+        log::error("saved.json is missing a value written through a held reference");
+    }
+}
@@ -0,0 +1,33 @@
+#include <Geode/loader/Mod.hpp>
+#include <Geode/loader/SettingV3.hpp>
+#include "Benchmark.hpp"
+
+using namespace geode::prelude;
+
+$on_mod(Loaded) {
+    auto handle = Mod::get()->getSettingHandle<std::string>("bench-string");
+    auto original = Mod::get()->getSettingValue<std::string>("bench-string");
+
+    // the handle has to keep seeing changes made through the usual API
+    if (handle.get() != original) {
+        log::error("SettingHandle returned '{}' instead of '{}'", handle.get(), original);
+    }
+    Mod::get()->setSettingValue<std::string>("bench-string", "changed");
+    if (handle.get() != "changed") {
+        log::error("SettingHandle didn't pick up the new value, got '{}'", handle.get());
+    }
+    Mod::get()->setSettingValue<std::string>("bench-string", original);
+
+    if (!shouldRunBenchmarks()) return;
+
+    size_t length = 0;
+    benchmark("getSettingValue<std::string>", 10'000'000, [&](size_t) {
+        length += Mod::get()->getSettingValue<std::string>("bench-string").size();
+    });
+    benchmark("SettingHandle<std::string>::get", 10'000'000, [&](size_t) {
+        length += handle.get().size();
+    });
+    if (length != original.size() * 20'000'000) {
+        log::error("Settings benchmark read the wrong values");
+    }
+}
@@ -0,0 +1,139 @@
+#include <Geode/loader/Dirs.hpp>
+#include <Geode/loader/Loader.hpp>
+#include <Geode/utils/file.hpp>
+#include "Benchmark.hpp"
+
+using namespace geode::prelude;
+
+static uint32_t computeCRC32(std::span<uint8_t const> data) {
+    uint32_t crc = 0xffffffff;
+    for (auto byte : data) {
+        crc ^= byte;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// Zip can only write compressed entries, so this builds a zip with a single
+// entry stored without compression by hand
+static ByteVector makeStoredZip(std::string const& name, std::string const& contents) {
+    ByteVector out;
+    auto u16 = [&](uint16_t value) {
+        out.push_back(value & 0xff);
+        out.push_back(value >> 8);
+    };
+    auto u32 = [&](uint32_t value) {
+        u16(value & 0xffff);
+        u16(value >> 16);
+    };
+    auto bytes = std::span(reinterpret_cast<uint8_t const*>(contents.data()), contents.size());
+    auto crc = computeCRC32(bytes);
+    auto size = static_cast<uint32_t>(contents.size());
+    auto nameLength = static_cast<uint16_t>(name.size());
+
+    // local header: signature, version, flags, method, time, date, crc,
+    // sizes, name and extra lengths
+    u32(0x04034b50); u16(10); u16(0); u16(0); u16(0); u16(0);
+    u32(crc); u32(size); u32(size); u16(nameLength); u16(0);
+    out.insert(out.end(), name.begin(), name.end());
+    out.insert(out.end(), bytes.begin(), bytes.end());
+
+    // central directory header for the same entry, at offset 0
+    auto directoryOffset = static_cast<uint32_t>(out.size());
+    u32(0x02014b50); u16(10); u16(10); u16(0); u16(0); u16(0); u16(0);
+    u32(crc); u32(size); u32(size); u16(nameLength); u16(0); u16(0);
+    u16(0); u16(0); u32(0); u32(0);
+    out.insert(out.end(), name.begin(), name.end());
+    auto directorySize = static_cast<uint32_t>(out.size()) - directoryOffset;
+
+    // end of central directory
+    u32(0x06054b50); u16(0); u16(0); u16(1); u16(1);
+    u32(directorySize); u32(directoryOffset); u16(0);
+    return out;
+}
+
+$on_mod(Loaded) {
+    std::string contents = "stored entries are copied straight out of the zip";
+    auto zip = makeStoredZip("stored.txt", contents);
+
+    if (auto unzip = file::Unzip::create(std::span<uint8_t const>(zip))) {
+        auto data = unzip.unwrap().extract("stored.txt");
+        if (!data || std::string(data.unwrap().begin(), data.unwrap().end()) != contents) {
+            log::error("Extracting a stored entry failed");
+        }
+    }
+    else {
+        log::error("Unable to open the stored zip: {}", unzip.unwrapErr());
+    }
+
+    // flip a byte of the entry's data, which only the CRC-32 can catch
+    auto corrupted = zip;
+    corrupted[30 + std::string_view("stored.txt").size()] ^= 0xff;
+    if (auto unzip = file::Unzip::create(std::span<uint8_t const>(corrupted))) {
+        if (unzip.unwrap().extract("stored.txt")) {
+            log::error("Extracting a corrupted stored entry didn't fail");
+        }
+        if (unzip.unwrap().view("stored.txt")) {
+            log::error("Viewing a corrupted stored entry didn't fail");
+        }
+        if (!unzip.unwrap().view("stored.txt", false)) {
+            log::error("Viewing a stored entry without verifying it failed");
+        }
+    }
+    else {
+        log::error("Unable to open the corrupted zip: {}", unzip.unwrapErr());
+    }
+
+    if (!shouldRunBenchmarks()) return;
+
+    // roughly the shape of the mods directory at startup: many different
+    // packages, so that opening one doesn't just hit the last one's caches
+    auto dir = dirs::getTempDir() / "zip-benchmark";
+    (void)file::createDirectoryAll(dir);
+    std::vector<std::filesystem::path> packages;
+    for (size_t p = 0; p < 200; p++) {
+        auto package = file::Zip::create();
+        if (!package) {
+            log::error("Unable to create a benchmark zip: {}", package.unwrapErr());
+            return;
+        }
+        (void)package.unwrap().add("mod.json", fmt::format(R"({{"id": "bench.zip-{}"}})", p));
+        for (size_t i = 0; i < 200; i++) {
+            (void)package.unwrap().add(fmt::format("resources/sprite-{}.png", i), ByteVector(4096, (i + p) % 251));
+        }
+        auto path = dir / fmt::format("bench.zip-{}.geode", p);
+        if (auto res = file::writeBinary(path, package.unwrap().getData()); !res) {
+            log::error("Unable to write a benchmark zip: {}", res.unwrapErr());
+            return;
+        }
+        packages.push_back(std::move(path));
+    }
+
+    auto stored = file::Unzip::create(std::span<uint8_t const>(zip));
+    if (!stored) {
+        log::error("Unable to open the stored zip: {}", stored.unwrapErr());
+        return;
+    }
+
+    // run once as is and once with --geode:disable-zip-mapping to compare
+    // the mapped path with mz_stream_os
+    auto reading = Loader::get()->getLaunchFlag("disable-zip-mapping") ? "mz_stream_os" : "mapped";
+    size_t found = 0;
+    benchmark(fmt::format("Unzip open + hasEntry + extract mod.json ({}, 200 packages)", reading), 1000, [&](size_t i) {
+        auto unzip = file::Unzip::create(packages[i % packages.size()]);
+        if (unzip && unzip.unwrap().hasEntry("mod.json")) {
+            found += unzip.unwrap().extract("mod.json").isOk();
+        }
+    });
+    benchmark("Unzip view stored entry", 1'000'000, [&](size_t) {
+        found += stored.unwrap().view("stored.txt").isOk();
+    });
+    if (found != 1'001'000) {
+        log::error("Expected 1001000 entries found, got {}", found);
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}